@@ -0,0 +1,49 @@
+/**
+ * @file arena.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for arena (bump) allocator, memory is released all at once
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Size of blocks shared by small allocations
+#define ARENA_BLOCK_SIZE ((size_t)1 << 20)
+// Larger allocations get their own block, so they can be resized and freed before release
+#define ARENA_LARGE_SIZE (ARENA_BLOCK_SIZE / 8)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct arena_block arena_block_t;
+
+    typedef struct arena
+    {
+        // all blocks, shared and large, in a doubly linked list
+        arena_block_t *blocks;
+        // free part of the current shared block
+        char *position;
+        char *end;
+        // last small allocation, it can grow in place
+        char *last;
+    } arena_t;
+
+    void arena_init(arena_t *arena);
+    void *arena_alloc(arena_t *arena, size_t n, size_t size);
+    void *arena_resize(arena_t *arena, void *ptr, size_t oldN, size_t n, size_t size);
+    void arena_free(arena_t *arena, void *ptr, size_t n, size_t size);
+    void arena_release(arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // ARENA_H
@@ -0,0 +1,50 @@
+/**
+ * @file batch.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for analysis of many graphs in one run
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "error.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Settings applied to every graph of batch.
+     */
+    typedef struct batch_options
+    {
+        // input format name, NULL is auto
+        const char *format;
+        unsigned int cycle_length_limit;
+        unsigned int repeat_count;
+        bool streaming;
+        // print operation counters
+        bool stats;
+        // print memory of phases
+        bool memory;
+        // limit of allocated bytes of every graph, 0 is no limit
+        uint64_t memory_limit;
+        // count of graphs analyzed at once
+        unsigned int thread_count;
+    } batch_options_t;
+
+    errorCodes_t batch_run(const char *const *sources, unsigned int sourceCount, FILE *stream, const batch_options_t *options, FILE *output);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BATCH_H
@@ -0,0 +1,37 @@
+/**
+ * @file bitset.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for vectorized operations on bitsets of 64-bit words
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Returned by bitset_next when there is no set bit
+#define BITSET_NONE UINT32_MAX
+
+#define BITSET_WORD_BITS 64
+#define BITSET_WORD_COUNT(bitCount) (((size_t)(bitCount) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    uint64_t bitset_and_count(const uint64_t *words, const uint64_t *words2, size_t wordCount);
+    bool bitset_take(uint64_t *remaining, const uint64_t *words, uint64_t *taken, size_t wordCount);
+    uint32_t bitset_next(const uint64_t *words, size_t wordCount, uint32_t from);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BITSET_H
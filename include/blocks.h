@@ -0,0 +1,50 @@
+/**
+ * @file blocks.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for decomposition of graph to biconnected components (blocks)
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+#include <stdint.h>
+#include "graph.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Biconnected component of graph with its own CSR adjacency and local vertex numbering.
+     * Neighbors of local vertex i are neighbors[offsets[i]] .. neighbors[offsets[i + 1] - 1],
+     * vertices[i] is the graph vertex of local vertex i.
+     */
+    typedef struct block
+    {
+        uint32_t node_count;
+        uint64_t edge_count;
+        uint64_t *offsets;
+        uint32_t *neighbors;
+        uint32_t *vertices;
+    } block_t;
+
+    /**
+     * @brief Block callback, block is valid only during the call
+     * @param block block of graph
+     * @param context callback context
+     */
+    typedef void (*block_callback_t)(const block_t *block, void *context);
+
+    vertex_span_t block_get_neighbors(const block_t *block, uint32_t vertex);
+    void graph_for_each_block(block_callback_t callback, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BLOCKS_H
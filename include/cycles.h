@@ -0,0 +1,51 @@
+/**
+ * @file cycles.h
+ * @authors Marek Gergel (xgerge01), Jindřich Šíma (xsimaj04)
+ * @brief declaration of functions and variables for counting simple cycles of graph
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "graph.h"
+#include "blocks.h"
+
+// Subset DP needs 2^(|V|-1) * (|V|-1) path counters, 20 nodes take 80 MB and counts fit 64 bits
+#define CYCLE_DP_MAX_NODE_COUNT 20
+// Subset DP is used for graphs with at least this fraction of all possible edges
+#define CYCLE_DP_MIN_DENSITY 0.5
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Simple cycle counts, by_length[k] is count of cycles of length k (k vertices and k edges).
+     */
+    typedef struct cycle_counts
+    {
+        uint64_t total;
+        uint32_t max_length;
+        uint64_t *by_length;
+    } cycle_counts_t;
+
+    void cycle_counts_init(cycle_counts_t *counts, uint32_t max_length);
+    void cycle_counts_destroy(cycle_counts_t *counts);
+    void cycle_counts_add_directed(cycle_counts_t *counts, const uint64_t *directed_counts, uint32_t max_length);
+    bool cycles_use_subset_dp(const block_t *block);
+    void cycles_count_johnson(const block_t *block, unsigned int thread_count, cycle_counts_t *counts);
+    void cycles_count_subset_dp(const block_t *block, unsigned int thread_count, cycle_counts_t *counts);
+    void cycles_count(unsigned int thread_count, cycle_counts_t *counts);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // CYCLES_H
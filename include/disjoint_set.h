@@ -0,0 +1,41 @@
+/**
+ * @file disjoint_set.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for disjoint set forest (union-find) of graph vertices
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef DISJOINT_SET_H
+#define DISJOINT_SET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct disjoint_set
+    {
+        uint32_t count;
+        uint32_t capacity;
+        uint32_t set_count;
+        uint32_t *parent;
+        uint8_t *rank;
+    } disjoint_set_t;
+
+    void disjoint_set_init(disjoint_set_t *set);
+    void disjoint_set_destroy(disjoint_set_t *set);
+    uint32_t disjoint_set_add(disjoint_set_t *set);
+    uint32_t disjoint_set_find(disjoint_set_t *set, uint32_t item);
+    bool disjoint_set_union(disjoint_set_t *set, uint32_t item, uint32_t item2);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // DISJOINT_SET_H
@@ -22,6 +22,7 @@ extern "C"
 #endif
     typedef enum errorCodes
     {
+        noError = 0,
         parserSyntaxError = 1,
         parserNodeCountZeroError = 2,
         parserNodeCountOverflowError = 3,
@@ -29,6 +30,9 @@ extern "C"
         graphNodeNameDuplicationError = 5,
         graphNodeNotFoundError = 6,
         graphNodeEdgeLoopError = 7,
+        parserBinaryFormatError = 8,
+        fileAccessError = 9,
+        memoryLimitError = 10,
         internalError = 99
     } errorCodes_t;
 
@@ -13,30 +13,91 @@
 #define GRAPH_H
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "error.h"
+#include "memory_usage.h"
 
-// Limited to 62 nodes, because of cycle count implementation
-#define MAX_NODE_COUNT (unsigned int)(sizeof(uint64_t) * 8) - 1
-#define MAX_NODE_EDGE_COUNT (MAX_NODE_COUNT - 1)
+// Limited by 32-bit node indices in graph adjacency arrays
+#define MAX_NODE_COUNT (unsigned int)(UINT32_MAX - 1)
+#define MAX_NODE_NAME_LENGTH 256
+
+// Binary graph file starts with this magic, first byte can not appear in text graph
+#define GRAPH_BINARY_MAGIC "\x89GBIN\r\n\x1a"
+#define GRAPH_BINARY_MAGIC_LENGTH 8
+#define GRAPH_BINARY_VERSION 1
+
+// Memory of alloc is preceded by its block header, aligned as any type
+#define ALLOC_HEADER_SIZE ((sizeof(memory_block_t) + _Alignof(max_align_t) - 1) / _Alignof(max_align_t) * _Alignof(max_align_t))
+
+// Dense graphs get bitset adjacency matrix, limited to 32 MiB
+#define GRAPH_MATRIX_MAX_NODE_COUNT 16384
+#define GRAPH_MATRIX_MIN_DENSITY 0.25
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-    typedef struct node node_t;
+    /**
+     * @brief Header of binary graph file, sections are stored in native byte order at 8 byte aligned positions:
+     * edge_offsets (uint64_t[node_count + 1]), edge_nodes (uint32_t[arc_count]),
+     * name_offsets (uint64_t[node_count + 1]) and names (null terminated names of all nodes).
+     */
+    typedef struct graph_binary_header
+    {
+        char magic[GRAPH_BINARY_MAGIC_LENGTH];
+        uint32_t version;
+        uint32_t node_count;
+        uint64_t edge_count;
+        uint64_t arc_count;
+        uint64_t names_length;
+        uint64_t edge_offsets_position;
+        uint64_t edge_nodes_position;
+        uint64_t name_offsets_position;
+        uint64_t names_position;
+    } graph_binary_header_t;
+
+    /**
+     * @brief Read-only view of vertex neighbors, valid until the graph is destroyed.
+     */
+    typedef struct vertex_span
+    {
+        const uint32_t *ids;
+        uint32_t count;
+    } vertex_span_t;
 
+    void *alloc(size_t n, size_t size);
+    void *alloc_resize(void *ptr, size_t n, size_t size);
+    void alloc_free(void *ptr);
+    void alloc_keep(void *ptr);
     void graph_init();
+    void graph_init_streaming();
+    void graph_load_binary(const char *data, size_t length, void *storage, size_t storageLength, bool storageMapped);
+    void graph_write_binary(FILE *stream);
     void graph_destroy();
-    void graph_create_node(char *nodeName);
-    void graph_create_edge(char *nodeName, char *node2Name);
+    void graph_create_node(const char *nodeName, size_t nodeNameLength);
+    void graph_create_numbered_nodes(uint64_t nodeCount, unsigned int firstNumber);
+    void graph_create_edge_by_index(uint32_t nodeIndex, uint32_t node2Index);
+    void graph_set_mirrored_edges();
+    void graph_create_edge(const char *nodeName, size_t nodeNameLength, const char *node2Name, size_t node2NameLength);
+    void graph_finalize();
     unsigned int graph_get_node_count();
-    node_t *graph_get_node_by_index(unsigned int nodeIndex);
-    unsigned int node_get_edge_count(node_t *node);
-    node_t *node_get_edge_node_by_index(node_t *node, unsigned int edgeNodeIndex);
-    unsigned int graph_get_node_index(node_t *node);
+    uint64_t graph_get_edge_count();
+    uint64_t graph_get_arc_count();
+    uint64_t graph_get_vertex_arc_offset(uint32_t vertex);
+    uint32_t graph_get_vertex_degree(uint32_t vertex);
+    vertex_span_t graph_get_vertex_neighbors(uint32_t vertex);
+    const char *graph_get_vertex_name(uint32_t vertex);
+    bool graph_has_adjacency_matrix();
+    size_t graph_get_matrix_row_word_count();
+    const uint64_t *graph_get_vertex_row(uint32_t vertex);
+    bool graph_is_streaming();
+    uint32_t graph_stream_get_component_count();
+    bool graph_stream_has_cycle();
 
 #ifdef __cplusplus
 }
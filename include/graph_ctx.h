@@ -0,0 +1,101 @@
+/**
+ * @file graph_ctx.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for graph context, handle of one analyzed graph
+ * and interface of graph properties library
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef GRAPH_CTX_H
+#define GRAPH_CTX_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include "error.h"
+#include "stats.h"
+#include "memory_usage.h"
+
+// Error message of failed call is truncated to this size
+#define GRAPH_CTX_ERROR_MESSAGE_SIZE 1024
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct graph graph_t;
+    typedef struct parser_state parser_state_t;
+    typedef struct properties properties_t;
+
+    /**
+     * @brief Graph context, holds everything of one analyzed graph, so contexts can be used
+     * concurrently from different threads (one context must not be used by 2 threads at once).
+     * Internal functions work with context bound to calling thread, library functions bind the context they get.
+     */
+    typedef struct graph_ctx
+    {
+        graph_t *graph;
+        parser_state_t *parser;
+        properties_t *properties;
+        unsigned int thread_count;
+        // only cycles up to this length are counted, 0 counts all cycles
+        unsigned int cycle_length_limit;
+        // count of analysis runs, runtimes of more runs are printed as statistics
+        unsigned int repeat_count;
+        // analysis output, NULL is stdout
+        FILE *output;
+        // warning messages, NULL is stderr
+        FILE *warning_output;
+        // operation counters are printed with analysis, counted only when compiled in
+        bool stats_enabled;
+        stats_t stats;
+        // tracked memory with its limit, memory of phases is printed with analysis when enabled
+        memory_usage_t memory;
+        bool memory_enabled;
+        memory_phase_t parse_memory;
+        memory_phase_t build_memory;
+        // error of the last failed call
+        errorCodes_t error_code;
+        char error_message[GRAPH_CTX_ERROR_MESSAGE_SIZE];
+    } graph_ctx_t;
+
+    /**
+     * @brief Operation run by graph_ctx_run with bound context
+     * @param argument operation argument
+     */
+    typedef void (*graph_ctx_operation_t)(void *argument);
+
+    graph_ctx_t *graph_ctx_create();
+    void graph_ctx_destroy(graph_ctx_t *ctx);
+    graph_ctx_t *graph_ctx_current();
+    graph_ctx_t *graph_ctx_bind(graph_ctx_t *ctx);
+    jmp_buf *graph_ctx_set_error_jump(jmp_buf *jump);
+    void graph_ctx_fail(errorCodes_t errcode, const char *msg, va_list args);
+    errorCodes_t graph_ctx_run(graph_ctx_t *ctx, graph_ctx_operation_t operation, void *argument);
+    const char *graph_ctx_get_error(graph_ctx_t *ctx);
+    bool graph_ctx_set_format(graph_ctx_t *ctx, const char *name);
+    void graph_ctx_set_thread_count(graph_ctx_t *ctx, unsigned int count);
+    void graph_ctx_set_cycle_length_limit(graph_ctx_t *ctx, unsigned int length);
+    void graph_ctx_set_repeat_count(graph_ctx_t *ctx, unsigned int count);
+    bool graph_ctx_set_stats(graph_ctx_t *ctx, bool enabled);
+    void graph_ctx_set_memory_limit(graph_ctx_t *ctx, uint64_t bytes);
+    void graph_ctx_set_memory_report(graph_ctx_t *ctx, bool enabled);
+    void graph_ctx_set_output(graph_ctx_t *ctx, FILE *output);
+    void graph_ctx_set_warning_output(graph_ctx_t *ctx, FILE *output);
+    errorCodes_t graph_ctx_parse(graph_ctx_t *ctx, FILE *stream, bool streaming);
+    errorCodes_t graph_ctx_analyze(graph_ctx_t *ctx);
+    errorCodes_t graph_ctx_write_binary(graph_ctx_t *ctx, FILE *stream);
+    unsigned int graph_ctx_get_node_count(graph_ctx_t *ctx);
+    uint64_t graph_ctx_get_edge_count(graph_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GRAPH_CTX_H
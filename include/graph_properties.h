@@ -22,7 +22,12 @@ extern "C"
 {
 #endif
 
+    void graph_properties_set_thread_count(unsigned int count);
+    void graph_properties_set_cycle_length_limit(unsigned int length);
+    void graph_properties_reset();
+    void graph_properties_destroy();
     void graph_analyze_properties();
+    void graph_analyze_streaming_properties();
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,83 @@
+/**
+ * @file memory_usage.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for accounting of allocated memory by phases of analysis
+ * and memory limit of graph context
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Header of memory allocated by alloc, live blocks of graph context are linked,
+     * so blocks left by failed call can be freed.
+     */
+    typedef struct memory_block
+    {
+        struct memory_block *previous;
+        struct memory_block *next;
+        // context which allocated the block
+        struct graph_ctx *owner;
+        // order of allocation in owner context, 0 is memory kept by the context
+        uint64_t sequence;
+        size_t size;
+    } memory_block_t;
+
+    /**
+     * @brief Tracked memory of graph context, updated atomically by all threads bound to the context.
+     */
+    typedef struct memory_usage
+    {
+        // live tracked bytes
+        uint64_t current;
+        // allocations fail above this count of live bytes, 0 is no limit
+        uint64_t limit;
+        // bytes allocated and maximum of live bytes since the last collection
+        uint64_t allocated;
+        uint64_t peak;
+        // live blocks of alloc, newest first, with sequence of the last allocated block
+        memory_block_t *blocks;
+        uint64_t sequence;
+        pthread_mutex_t lock;
+    } memory_usage_t;
+
+    /**
+     * @brief Memory of one phase of analysis.
+     */
+    typedef struct memory_phase
+    {
+        uint64_t allocated;
+        uint64_t peak;
+    } memory_phase_t;
+
+    void memory_usage_allocate(uint64_t bytes);
+    void memory_usage_release(uint64_t bytes);
+    bool memory_usage_fits(uint64_t bytes);
+    void memory_usage_collect(memory_phase_t *phase);
+    uint64_t memory_usage_peak_rss();
+    void memory_phase_print(const memory_phase_t *phase, FILE *output);
+    void memory_block_attach(memory_block_t *block);
+    void memory_block_detach(memory_block_t *block);
+    void memory_block_keep(memory_block_t *block);
+    uint64_t memory_scope_begin();
+    void memory_scope_release(uint64_t scope);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // MEMORY_USAGE_H
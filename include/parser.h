@@ -18,14 +18,16 @@
 #include "graph.h"
 #include "error.h"
 
-#define MAX_NODE_NAME_LENGTH 256
-
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+    bool parser_set_format(const char *name);
     void parse_data(FILE *stream);
+    void parse_data_streaming(FILE *stream);
+    void parser_release();
+    void parser_destroy();
 
 #ifdef __cplusplus
 }
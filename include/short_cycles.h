@@ -0,0 +1,34 @@
+/**
+ * @file short_cycles.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for counting short simple cycles of graph
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef SHORT_CYCLES_H
+#define SHORT_CYCLES_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "cycles.h"
+
+// Shortest simple cycle of simple graph
+#define SHORT_CYCLE_MIN_LENGTH 3
+// Closing vertices on search path are marked by bits of 32-bit word
+#define SHORT_CYCLE_MAX_LENGTH 32
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void short_cycles_count(uint32_t max_length, unsigned int thread_count, cycle_counts_t *counts);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SHORT_CYCLES_H
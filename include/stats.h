@@ -0,0 +1,73 @@
+/**
+ * @file stats.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for counters of operations in hot paths,
+ * counters are compiled in only with GRAPH_STATS defined (make STATS=1), otherwise they cost nothing
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Counted operations.
+     */
+    typedef enum stats_counter
+    {
+        // vertices entered by depth first searches
+        vertexVisitsCounter,
+        // neighbors examined by depth first searches
+        edgeRelaxationsCounter,
+        // maximal path depth of depth first searches (maximum, not sum)
+        maxDepthCounter,
+        // stored names compared with searched name in name index
+        nameComparisonsCounter,
+        // bytes of input read by parser
+        bytesParsedCounter,
+        statsCounterCount
+    } stats_counter_t;
+
+    /**
+     * @brief Values of all counters.
+     */
+    typedef struct stats
+    {
+        uint64_t counters[statsCounterCount];
+    } stats_t;
+
+#ifdef GRAPH_STATS
+    // counters of calling thread, they are added to its graph context by stats_flush
+    extern _Thread_local stats_t stats_local;
+    extern _Thread_local uint64_t stats_depth;
+
+#define STATS_ADD(counter, count) ((void)(stats_local.counters[counter] += (count)))
+#define STATS_ENTER() ((void)(++stats_depth > stats_local.counters[maxDepthCounter] ? stats_local.counters[maxDepthCounter] = stats_depth : 0))
+#define STATS_LEAVE() ((void)stats_depth--)
+#else
+#define STATS_ADD(counter, count) ((void)0)
+#define STATS_ENTER() ((void)0)
+#define STATS_LEAVE() ((void)0)
+#endif
+
+    bool stats_available();
+    void stats_flush();
+    void stats_take(stats_t *stats);
+    void stats_print(const stats_t *stats, FILE *output);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // STATS_H
@@ -0,0 +1,36 @@
+/**
+ * @file thread_pool.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for parallel execution of independent tasks
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Task function, called once for every task index
+     * @param context shared context of all tasks
+     * @param worker_index index of the worker running the task (0 .. thread_count - 1)
+     * @param task_index index of the task
+     */
+    typedef void (*thread_pool_task_t)(void *context, unsigned int worker_index, uint64_t task_index);
+
+    unsigned int thread_pool_get_processor_count();
+    void thread_pool_run(unsigned int thread_count, uint64_t task_count, thread_pool_task_t task, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // THREAD_POOL_H
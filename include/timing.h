@@ -0,0 +1,56 @@
+/**
+ * @file timing.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for monotonic nanosecond timing of nested measurements
+ * and statistics of repeated measurements
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+
+// Maximal count of measurements running at once
+#define TIMING_MAX_DEPTH 16
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Stack of running measurements, every stop ends the most recently started measurement,
+     * so measured function may measure functions it calls.
+     */
+    typedef struct timing
+    {
+        uint64_t starts[TIMING_MAX_DEPTH];
+        unsigned int depth;
+        // duration of the last stopped measurement in nanoseconds
+        uint64_t last;
+    } timing_t;
+
+    /**
+     * @brief Statistics of repeated measurement in nanoseconds.
+     */
+    typedef struct timing_summary
+    {
+        uint64_t min;
+        uint64_t median;
+        uint64_t p99;
+    } timing_summary_t;
+
+    uint64_t timing_now();
+    void timing_start(timing_t *timing);
+    uint64_t timing_stop(timing_t *timing);
+    void timing_summarize(uint64_t *samples, unsigned int count, timing_summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TIMING_H
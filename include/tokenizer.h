@@ -0,0 +1,36 @@
+/**
+ * @file tokenizer.h
+ * @author Marek Gergel (xgerge01)
+ * @brief declaration of functions and variables for vectorized classification of input characters
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Scan of name characters, returns count of name characters at the beginning of data.
+     * @param data input data
+     * @param length input data length
+     */
+    typedef size_t (*tokenizer_scan_t)(const char *data, size_t length);
+
+    bool tokenizer_is_name_char(int c);
+    tokenizer_scan_t tokenizer_select_scan();
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TOKENIZER_H
@@ -0,0 +1,228 @@
+/**
+ * @file arena.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for arena (bump) allocator, small allocations are carved
+ * from shared blocks by moving a pointer, large allocations get their own block and everything is released
+ * by one walk over the block list
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "../include/arena.h"
+#include "../include/error.h"
+#include "../include/memory_usage.h"
+
+struct arena_block
+{
+    arena_block_t *previous;
+    arena_block_t *next;
+    // size of block data, counted to memory usage
+    size_t size;
+};
+
+// allocations are aligned as any type, block data start after header rounded to the alignment
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+#define ARENA_ROUND_UP(bytes) (((bytes) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+#define ARENA_HEADER_SIZE ARENA_ROUND_UP(sizeof(arena_block_t))
+#define ARENA_BLOCK_DATA(block) ((char *)(block) + ARENA_HEADER_SIZE)
+#define ARENA_DATA_BLOCK(ptr) ((arena_block_t *)((char *)(ptr)-ARENA_HEADER_SIZE))
+
+/**
+ * @brief Internal function returns size of n elements.
+ * @throw Error when size overflows.
+ * @param n number of elements
+ * @param size size of each element
+ * @return size_t size in bytes, at least 1
+ */
+size_t arena_bytes(size_t n, size_t size)
+{
+    if (size != 0 && n > (SIZE_MAX - ARENA_HEADER_SIZE - ARENA_ALIGNMENT) / size)
+    {
+        error_exit(internalError, "Memory allocation failed\n");
+    }
+    return n * size != 0 ? n * size : 1;
+}
+
+/**
+ * @brief Internal function allocates zeroed block and links it to arena.
+ * @throw Error when allocation fails or memory limit is exceeded.
+ * @param arena arena structure pointer
+ * @param bytes size of block data
+ * @return arena_block_t* block
+ */
+arena_block_t *arena_block_create(arena_t *arena, size_t bytes)
+{
+    memory_usage_allocate(bytes);
+    arena_block_t *block = (arena_block_t *)calloc(1, ARENA_HEADER_SIZE + bytes);
+    if (!block)
+    {
+        memory_usage_release(bytes);
+        error_exit(internalError, "Memory allocation failed\n");
+    }
+    block->size = bytes;
+    block->next = arena->blocks;
+    if (arena->blocks)
+    {
+        arena->blocks->previous = block;
+    }
+    arena->blocks = block;
+    return block;
+}
+
+/**
+ * @brief Internal function points neighbors of moved or removed block to replacement.
+ * @param arena arena structure pointer
+ * @param block block whose neighbors are updated
+ * @param replacement block at the same list position or NULL when block is removed
+ */
+void arena_block_relink(arena_t *arena, arena_block_t *block, arena_block_t *replacement)
+{
+    arena_block_t *previous = replacement ? replacement : block->previous;
+    arena_block_t *next = replacement ? replacement : block->next;
+    if (block->previous)
+    {
+        block->previous->next = next;
+    }
+    else
+    {
+        arena->blocks = next;
+    }
+    if (block->next)
+    {
+        block->next->previous = previous;
+    }
+}
+
+/**
+ * @brief Function initializes empty arena.
+ * @param arena arena structure pointer
+ */
+void arena_init(arena_t *arena)
+{
+    arena->blocks = NULL;
+    arena->position = NULL;
+    arena->end = NULL;
+    arena->last = NULL;
+}
+
+/**
+ * @brief Function allocates zeroed memory for n elements from arena, memory stays valid until the arena is released.
+ * Arena must not be used concurrently.
+ * @throw Error when allocation fails.
+ * @param arena arena structure pointer
+ * @param n number of elements
+ * @param size size of each element
+ * @return void* pointer to the allocated memory
+ */
+void *arena_alloc(arena_t *arena, size_t n, size_t size)
+{
+    size_t bytes = arena_bytes(n, size);
+    if (bytes > ARENA_LARGE_SIZE)
+    {
+        return ARENA_BLOCK_DATA(arena_block_create(arena, bytes));
+    }
+    bytes = ARENA_ROUND_UP(bytes);
+    if ((size_t)(arena->end - arena->position) < bytes)
+    {
+        arena->position = ARENA_BLOCK_DATA(arena_block_create(arena, ARENA_BLOCK_SIZE));
+        arena->end = arena->position + ARENA_BLOCK_SIZE;
+    }
+    arena->last = arena->position;
+    arena->position += bytes;
+    return arena->last;
+}
+
+/**
+ * @brief Function resizes arena memory, large memory is reallocated, the last small allocation grows in place
+ * and other memory is copied to a new allocation. New memory is not zeroed.
+ * @throw Error when allocation fails.
+ * @param arena arena structure pointer
+ * @param ptr memory allocated from arena or NULL
+ * @param oldN number of elements ptr was allocated for
+ * @param n new number of elements
+ * @param size size of each element
+ * @return void* pointer to the resized memory
+ */
+void *arena_resize(arena_t *arena, void *ptr, size_t oldN, size_t n, size_t size)
+{
+    if (!ptr)
+    {
+        return arena_alloc(arena, n, size);
+    }
+    size_t old_bytes = arena_bytes(oldN, size);
+    size_t bytes = arena_bytes(n, size);
+    if (old_bytes > ARENA_LARGE_SIZE && bytes > ARENA_LARGE_SIZE)
+    {
+        arena_block_t *block = ARENA_DATA_BLOCK(ptr);
+        if (bytes > block->size)
+        {
+            memory_usage_allocate(bytes - block->size);
+        }
+        arena_block_t *resized = (arena_block_t *)realloc(block, ARENA_HEADER_SIZE + bytes);
+        if (!resized)
+        {
+            if (bytes > block->size)
+            {
+                memory_usage_release(bytes - block->size);
+            }
+            error_exit(internalError, "Memory allocation failed\n");
+        }
+        if (bytes < resized->size)
+        {
+            memory_usage_release(resized->size - bytes);
+        }
+        resized->size = bytes;
+        arena_block_relink(arena, resized, resized);
+        return ARENA_BLOCK_DATA(resized);
+    }
+    if (ptr == arena->last && bytes <= ARENA_LARGE_SIZE && ARENA_ROUND_UP(bytes) <= (size_t)(arena->end - arena->last))
+    {
+        arena->position = arena->last + ARENA_ROUND_UP(bytes);
+        return ptr;
+    }
+    void *resized = arena_alloc(arena, n, size);
+    memcpy(resized, ptr, old_bytes < bytes ? old_bytes : bytes);
+    arena_free(arena, ptr, oldN, size);
+    return resized;
+}
+
+/**
+ * @brief Function returns large memory to the system before the arena is released,
+ * small memory stays in its shared block until release.
+ * @param arena arena structure pointer
+ * @param ptr memory allocated from arena or NULL
+ * @param n number of elements ptr was allocated for
+ * @param size size of each element
+ */
+void arena_free(arena_t *arena, void *ptr, size_t n, size_t size)
+{
+    if (ptr && arena_bytes(n, size) > ARENA_LARGE_SIZE)
+    {
+        arena_block_t *block = ARENA_DATA_BLOCK(ptr);
+        arena_block_relink(arena, block, NULL);
+        memory_usage_release(block->size);
+        free(block);
+    }
+}
+
+/**
+ * @brief Function releases all memory allocated from arena.
+ * @param arena arena structure pointer
+ */
+void arena_release(arena_t *arena)
+{
+    arena_block_t *block = arena->blocks;
+    while (block)
+    {
+        arena_block_t *next = block->next;
+        memory_usage_release(block->size);
+        free(block);
+        block = next;
+    }
+    arena_init(arena);
+}
@@ -0,0 +1,356 @@
+/**
+ * @file batch.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for analysis of many graphs in one run,
+ * every graph gets its own graph context, graphs are analyzed in parallel on thread pool
+ * and their results are printed in order of sources
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+#include "../include/batch.h"
+#include "../include/graph.h"
+#include "../include/graph_ctx.h"
+#include "../include/thread_pool.h"
+
+// size of the first block of read stream
+#define BATCH_READ_SIZE (1 << 16)
+// size of buffer for name of graph from stream
+#define BATCH_NAME_SIZE 32
+
+/**
+ * @brief One analyzed graph, read from file or from memory.
+ */
+typedef struct batch_job
+{
+    // source name printed before result
+    char *name;
+    // graph file, NULL when graph is in memory
+    char *path;
+    const char *data;
+    size_t length;
+    // printed analysis or error of the graph
+    char *result;
+    size_t result_length;
+    errorCodes_t code;
+} batch_job_t;
+
+/**
+ * @brief Batch of graphs with shared settings.
+ */
+typedef struct batch
+{
+    batch_job_t *jobs;
+    unsigned int job_count;
+    unsigned int job_capacity;
+    const batch_options_t *options;
+    // concatenated graphs read from stream, jobs point into it
+    char *stream_data;
+} batch_t;
+
+/**
+ * @brief Internal function returns allocated copy of string.
+ * @param string string
+ * @return char* copy
+ */
+char *batch_copy_string(const char *string)
+{
+    size_t length = strlen(string);
+    char *copy = (char *)alloc(length + 1, sizeof(char));
+    memcpy(copy, string, length);
+    return copy;
+}
+
+/**
+ * @brief Internal function adds graph to batch.
+ * @param batch batch structure pointer
+ * @param name source name
+ * @param path graph file or NULL
+ * @param data graph data when path is NULL
+ * @param length graph data length
+ */
+void batch_add_job(batch_t *batch, const char *name, const char *path, const char *data, size_t length)
+{
+    if (batch->job_count == batch->job_capacity)
+    {
+        batch->job_capacity = batch->job_capacity ? batch->job_capacity * 2 : 16;
+        batch->jobs = (batch_job_t *)alloc_resize(batch->jobs, batch->job_capacity, sizeof(batch_job_t));
+    }
+    batch->jobs[batch->job_count++] = (batch_job_t){
+        .name = batch_copy_string(name),
+        .path = path ? batch_copy_string(path) : NULL,
+        .data = data,
+        .length = length,
+    };
+}
+
+/**
+ * @brief Internal comparison of file names for qsort.
+ * @param name first name pointer
+ * @param name2 second name pointer
+ * @return int order of names
+ */
+int batch_compare_names(const void *name, const void *name2)
+{
+    return strcmp(*(char *const *)name, *(char *const *)name2);
+}
+
+/**
+ * @brief Internal function adds all regular files of directory to batch, sorted by name.
+ * @throw Error when directory can not be read.
+ * @param batch batch structure pointer
+ * @param directory directory path
+ */
+void batch_add_directory(batch_t *batch, const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (!dir)
+    {
+        error_exit(fileAccessError, "Directory '%s' can not be opened\n", directory);
+    }
+
+    char **paths = NULL;
+    size_t path_count = 0;
+    size_t path_capacity = 0;
+    size_t directory_length = strlen(directory);
+    bool separator = directory_length != 0 && directory[directory_length - 1] != '/';
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t entry_length = strlen(entry->d_name);
+        char *path = (char *)alloc(directory_length + separator + entry_length + 1, sizeof(char));
+        memcpy(path, directory, directory_length);
+        if (separator)
+        {
+            path[directory_length] = '/';
+        }
+        memcpy(path + directory_length + separator, entry->d_name, entry_length);
+
+        struct stat stat_info;
+        if (stat(path, &stat_info) != 0 || !S_ISREG(stat_info.st_mode))
+        {
+            alloc_free(path);
+            continue;
+        }
+        if (path_count == path_capacity)
+        {
+            path_capacity = path_capacity ? path_capacity * 2 : 16;
+            paths = (char **)alloc_resize(paths, path_capacity, sizeof(char *));
+        }
+        paths[path_count++] = path;
+    }
+    closedir(dir);
+
+    qsort(paths, path_count, sizeof(char *), batch_compare_names);
+    for (size_t i = 0; i < path_count; i++)
+    {
+        batch_add_job(batch, paths[i], paths[i], NULL, 0);
+        alloc_free(paths[i]);
+    }
+    alloc_free(paths);
+}
+
+/**
+ * @brief Internal function returns if data contain only blank characters.
+ * @param data data
+ * @param length data length
+ * @return bool data are blank
+ */
+bool batch_is_blank(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (data[i] != ' ' && data[i] != '\t' && data[i] != '\r' && data[i] != '\n')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Internal function reads whole stream and adds its graphs to batch. Graphs in graph format
+ * are split after their edge list, so every pair of top level {...} lists is one graph named stdin#N.
+ * Input in other formats is one graph.
+ * @param batch batch structure pointer
+ * @param stream input stream
+ */
+void batch_add_stream(batch_t *batch, FILE *stream)
+{
+    size_t capacity = BATCH_READ_SIZE;
+    size_t length = 0;
+    char *data = (char *)alloc(capacity, sizeof(char));
+    size_t read_length;
+    while ((read_length = fread(data + length, sizeof(char), capacity - length, stream)) > 0)
+    {
+        length += read_length;
+        if (length == capacity)
+        {
+            capacity *= 2;
+            data = (char *)alloc_resize(data, capacity, sizeof(char));
+        }
+    }
+    batch->stream_data = data;
+
+    size_t start = 0;
+    while (start < length && batch_is_blank(&data[start], 1))
+    {
+        start++;
+    }
+    if (start == length)
+    {
+        return;
+    }
+    const char *format = batch->options->format;
+    if (data[start] != '{' || (format && strcmp(format, "auto") != 0 && strcmp(format, "graph") != 0))
+    {
+        batch_add_job(batch, "stdin", NULL, data, length);
+        return;
+    }
+
+    unsigned int depth = 0;
+    unsigned int list_count = 0;
+    unsigned int graph_count = 0;
+    for (size_t i = start; i < length; i++)
+    {
+        if (data[i] == '{')
+        {
+            depth++;
+        }
+        else if (data[i] == '}' && depth != 0 && --depth == 0 && ++list_count == 2)
+        {
+            char name[BATCH_NAME_SIZE];
+            snprintf(name, BATCH_NAME_SIZE, "stdin#%u", ++graph_count);
+            batch_add_job(batch, name, NULL, &data[start], i + 1 - start);
+            list_count = 0;
+            start = i + 1;
+            while (start < length && batch_is_blank(&data[start], 1))
+            {
+                start++;
+            }
+        }
+    }
+    // unfinished graph is analyzed, so its error is reported
+    if (!batch_is_blank(&data[start], length - start))
+    {
+        char name[BATCH_NAME_SIZE];
+        snprintf(name, BATCH_NAME_SIZE, "stdin#%u", ++graph_count);
+        batch_add_job(batch, name, NULL, &data[start], length - start);
+    }
+}
+
+/**
+ * @brief Internal task analyzes one graph of batch to its result buffer.
+ * @param context batch structure pointer
+ * @param worker_index index of worker (unused)
+ * @param task_index job index
+ */
+void batch_task(void *context, unsigned int worker_index, uint64_t task_index)
+{
+    (void)worker_index;
+    batch_t *batch = (batch_t *)context;
+    batch_job_t *job = &batch->jobs[task_index];
+
+    FILE *output = open_memstream(&job->result, &job->result_length);
+    graph_ctx_t *ctx = graph_ctx_create();
+    if (!output || !ctx)
+    {
+        error_exit(internalError, "Memory allocation failed\n");
+    }
+    graph_ctx_set_output(ctx, output);
+    graph_ctx_set_warning_output(ctx, output);
+    graph_ctx_set_cycle_length_limit(ctx, batch->options->cycle_length_limit);
+    graph_ctx_set_repeat_count(ctx, batch->options->repeat_count);
+    graph_ctx_set_stats(ctx, batch->options->stats);
+    graph_ctx_set_memory_report(ctx, batch->options->memory);
+    graph_ctx_set_memory_limit(ctx, batch->options->memory_limit);
+    if (batch->options->format)
+    {
+        graph_ctx_set_format(ctx, batch->options->format);
+    }
+
+    FILE *input = job->path ? fopen(job->path, "rb") : fmemopen((void *)job->data, job->length, "rb");
+    if (!input)
+    {
+        job->code = fileAccessError;
+        fprintf(output, "Error: File '%s' can not be opened\n", job->name);
+    }
+    else
+    {
+        job->code = graph_ctx_parse(ctx, input, batch->options->streaming);
+        fclose(input);
+        if (job->code == noError)
+        {
+            job->code = graph_ctx_analyze(ctx);
+        }
+        if (job->code != noError)
+        {
+            fprintf(output, "Error: %s", graph_ctx_get_error(ctx));
+        }
+    }
+
+    graph_ctx_destroy(ctx);
+    fclose(output);
+}
+
+/**
+ * @brief Function analyzes graphs of all sources in parallel and prints their results in order of sources,
+ * every result is preceded by line with source name and followed by empty line.
+ * Directory sources are expanded to their regular files sorted by name, without sources graphs are read from stream.
+ * @param sources graph files and directories
+ * @param sourceCount count of sources
+ * @param stream stream with concatenated graphs, used when there are no sources
+ * @param options settings of all graphs
+ * @param output output stream of results
+ * @return errorCodes_t noError or error code of the first graph which failed
+ */
+errorCodes_t batch_run(const char *const *sources, unsigned int sourceCount, FILE *stream, const batch_options_t *options, FILE *output)
+{
+    batch_t batch = {.options = options};
+    for (unsigned int i = 0; i < sourceCount; i++)
+    {
+        struct stat stat_info;
+        if (stat(sources[i], &stat_info) == 0 && S_ISDIR(stat_info.st_mode))
+        {
+            batch_add_directory(&batch, sources[i]);
+        }
+        else
+        {
+            batch_add_job(&batch, sources[i], sources[i], NULL, 0);
+        }
+    }
+    if (sourceCount == 0)
+    {
+        batch_add_stream(&batch, stream);
+    }
+
+    unsigned int thread_count = options->thread_count ? options->thread_count : thread_pool_get_processor_count();
+    thread_pool_run(thread_count, batch.job_count, batch_task, &batch);
+
+    errorCodes_t code = noError;
+    for (unsigned int i = 0; i < batch.job_count; i++)
+    {
+        batch_job_t *job = &batch.jobs[i];
+        fprintf(output, "%s\n", job->name);
+        fwrite(job->result, sizeof(char), job->result_length, output);
+        fprintf(output, "\n");
+        if (code == noError)
+        {
+            code = job->code;
+        }
+        alloc_free(job->name);
+        alloc_free(job->path);
+        free(job->result);
+    }
+    alloc_free(batch.jobs);
+    alloc_free(batch.stream_data);
+    return code;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file bitset.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for vectorized operations on bitsets of 64-bit words,
+ * intersection counts are computed 4 words at a time (AVX2) or word by word with
+ * POPCNT instruction, implementation is selected by CPU features on the first call
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <pthread.h>
+#include "../include/bitset.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BITSET_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Bitset kernels of one instruction set.
+ */
+typedef struct bitset_kernels
+{
+    uint64_t (*and_count)(const uint64_t *words, const uint64_t *words2, size_t wordCount);
+    bool (*take)(uint64_t *remaining, const uint64_t *words, uint64_t *taken, size_t wordCount);
+} bitset_kernels_t;
+
+/**
+ * @brief Scalar count of bits set in both bitsets.
+ * @param words first bitset words
+ * @param words2 second bitset words
+ * @param wordCount count of words
+ * @return uint64_t count of set bits of intersection
+ */
+uint64_t bitset_and_count_scalar(const uint64_t *words, const uint64_t *words2, size_t wordCount)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < wordCount; i++)
+    {
+        count += (uint64_t)__builtin_popcountll(words[i] & words2[i]);
+    }
+    return count;
+}
+
+/**
+ * @brief Scalar move of bits set in words from remaining to taken.
+ * @param remaining bitset, bits of words are cleared
+ * @param words bitset of bits to take
+ * @param taken bitset where taken bits are stored, previous content is overwritten
+ * @param wordCount count of words
+ * @return bool any bit was taken
+ */
+bool bitset_take_scalar(uint64_t *remaining, const uint64_t *words, uint64_t *taken, size_t wordCount)
+{
+    uint64_t any = 0;
+    for (size_t i = 0; i < wordCount; i++)
+    {
+        taken[i] = remaining[i] & words[i];
+        remaining[i] &= ~words[i];
+        any |= taken[i];
+    }
+    return any != 0;
+}
+
+#ifdef BITSET_X86
+/**
+ * @brief Count of bits set in both bitsets with POPCNT instruction.
+ * @param words first bitset words
+ * @param words2 second bitset words
+ * @param wordCount count of words
+ * @return uint64_t count of set bits of intersection
+ */
+__attribute__((target("popcnt"))) uint64_t bitset_and_count_popcnt(const uint64_t *words, const uint64_t *words2, size_t wordCount)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < wordCount; i++)
+    {
+        count += (uint64_t)__builtin_popcountll(words[i] & words2[i]);
+    }
+    return count;
+}
+
+/**
+ * @brief AVX2 count of set bits of every byte of block, bytes are split to nibbles which are counted
+ * by table lookup and summed to 4 64-bit counts.
+ * @param block 4 bitset words
+ * @return __m256i set bit counts of the 4 words
+ */
+__attribute__((target("avx2"))) __m256i bitset_block_count_avx2(__m256i block)
+{
+    const __m256i nibble_counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+    __m256i low = _mm256_and_si256(block, nibble_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask);
+    __m256i byte_counts = _mm256_add_epi8(_mm256_shuffle_epi8(nibble_counts, low), _mm256_shuffle_epi8(nibble_counts, high));
+    return _mm256_sad_epu8(byte_counts, _mm256_setzero_si256());
+}
+
+/**
+ * @brief AVX2 sum of 4 64-bit counts.
+ * @param counts 4 counts
+ * @return uint64_t sum of counts
+ */
+__attribute__((target("avx2"))) uint64_t bitset_counts_sum_avx2(__m256i counts)
+{
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * @brief AVX2 count of bits set in both bitsets, 4 words at a time.
+ * @param words first bitset words
+ * @param words2 second bitset words
+ * @param wordCount count of words
+ * @return uint64_t count of set bits of intersection
+ */
+__attribute__((target("avx2,popcnt"))) uint64_t bitset_and_count_avx2(const uint64_t *words, const uint64_t *words2, size_t wordCount)
+{
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= wordCount; i += 4)
+    {
+        __m256i block = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(words + i)), _mm256_loadu_si256((const __m256i *)(words2 + i)));
+        counts = _mm256_add_epi64(counts, bitset_block_count_avx2(block));
+    }
+    return bitset_counts_sum_avx2(counts) + bitset_and_count_popcnt(words + i, words2 + i, wordCount - i);
+}
+
+/**
+ * @brief AVX2 move of bits set in words from remaining to taken, 4 words at a time.
+ * @param remaining bitset, bits of words are cleared
+ * @param words bitset of bits to take
+ * @param taken bitset where taken bits are stored, previous content is overwritten
+ * @param wordCount count of words
+ * @return bool any bit was taken
+ */
+__attribute__((target("avx2"))) bool bitset_take_avx2(uint64_t *remaining, const uint64_t *words, uint64_t *taken, size_t wordCount)
+{
+    __m256i any = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= wordCount; i += 4)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(words + i));
+        __m256i remaining_block = _mm256_loadu_si256((const __m256i *)(remaining + i));
+        __m256i taken_block = _mm256_and_si256(remaining_block, block);
+        _mm256_storeu_si256((__m256i *)(taken + i), taken_block);
+        _mm256_storeu_si256((__m256i *)(remaining + i), _mm256_andnot_si256(block, remaining_block));
+        any = _mm256_or_si256(any, taken_block);
+    }
+    bool tail_any = bitset_take_scalar(remaining + i, words + i, taken + i, wordCount - i);
+    return !_mm256_testz_si256(any, any) || tail_any;
+}
+#endif
+
+/**
+ * @brief Select bitset kernels supported by CPU.
+ * @return bitset_kernels_t kernels
+ */
+bitset_kernels_t bitset_kernels_select()
+{
+#ifdef BITSET_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        return (bitset_kernels_t){bitset_and_count_avx2, bitset_take_avx2};
+    }
+    if (__builtin_cpu_supports("popcnt"))
+    {
+        return (bitset_kernels_t){bitset_and_count_popcnt, bitset_take_scalar};
+    }
+#endif
+    return (bitset_kernels_t){bitset_and_count_scalar, bitset_take_scalar};
+}
+
+bitset_kernels_t bitset_kernels = {bitset_and_count_scalar, bitset_take_scalar};
+pthread_once_t bitset_kernels_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Select bitset kernels supported by CPU, called once.
+ */
+void bitset_kernels_init()
+{
+    bitset_kernels = bitset_kernels_select();
+}
+
+/**
+ * @brief Function returns count of bits set in both bitsets (size of intersection).
+ * @param words first bitset words
+ * @param words2 second bitset words
+ * @param wordCount count of words
+ * @return uint64_t count of set bits of intersection
+ */
+uint64_t bitset_and_count(const uint64_t *words, const uint64_t *words2, size_t wordCount)
+{
+    pthread_once(&bitset_kernels_once, bitset_kernels_init);
+    return bitset_kernels.and_count(words, words2, wordCount);
+}
+
+/**
+ * @brief Function moves bits set in words from remaining to taken (taken = remaining & words, remaining &= ~words).
+ * @param remaining bitset, bits of words are cleared
+ * @param words bitset of bits to take
+ * @param taken bitset where taken bits are stored, previous content is overwritten
+ * @param wordCount count of words
+ * @return bool any bit was taken
+ */
+bool bitset_take(uint64_t *remaining, const uint64_t *words, uint64_t *taken, size_t wordCount)
+{
+    pthread_once(&bitset_kernels_once, bitset_kernels_init);
+    return bitset_kernels.take(remaining, words, taken, wordCount);
+}
+
+/**
+ * @brief Function returns index of the first set bit at or after from, set bits are iterated
+ * by calling it again with the previous index + 1.
+ * @param words bitset words
+ * @param wordCount count of words
+ * @param from index of the first bit to check
+ * @return uint32_t index of set bit or BITSET_NONE
+ */
+uint32_t bitset_next(const uint64_t *words, size_t wordCount, uint32_t from)
+{
+    size_t word = from / BITSET_WORD_BITS;
+    if (word >= wordCount)
+    {
+        return BITSET_NONE;
+    }
+    uint64_t bits = words[word] & (~(uint64_t)0 << (from % BITSET_WORD_BITS));
+    while (bits == 0)
+    {
+        if (++word == wordCount)
+        {
+            return BITSET_NONE;
+        }
+        bits = words[word];
+    }
+    return (uint32_t)(word * BITSET_WORD_BITS + (size_t)__builtin_ctzll(bits));
+}
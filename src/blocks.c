@@ -0,0 +1,230 @@
+/**
+ * @file blocks.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for decomposition of graph to biconnected components (blocks),
+ * every simple cycle lies in exactly one block, bridges are blocks with single edge
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../include/blocks.h"
+
+/**
+ * @brief Tarjan's DFS frame, vertex and position of the next neighbor to search.
+ */
+typedef struct block_frame
+{
+    uint32_t vertex;
+    uint32_t cursor;
+} block_frame_t;
+
+/**
+ * @brief State of block decomposition.
+ */
+typedef struct block_search
+{
+    // discovery time (0 - not discovered) and lowest reachable discovery time
+    uint32_t *discovery;
+    uint32_t *low;
+    uint32_t *parent;
+    uint32_t time;
+    block_frame_t *frames;
+    uint32_t frame_count;
+    // stack of searched edges, edges of a block are on top of it when block is completed
+    uint32_t *edges;
+    uint64_t edge_count;
+    // local vertex of graph vertex, valid when local_mark equals current block number
+    uint32_t *local_vertex;
+    uint32_t *local_mark;
+    uint32_t block_number;
+    block_t block;
+} block_search_t;
+
+/**
+ * @brief Function returns local indexes of all block vertices connected to local vertex
+ * @param block block structure pointer
+ * @param vertex local vertex index
+ * @return vertex_span_t neighbor local indexes
+ */
+vertex_span_t block_get_neighbors(const block_t *block, uint32_t vertex)
+{
+    vertex_span_t span = {
+        .ids = &block->neighbors[block->offsets[vertex]],
+        .count = (uint32_t)(block->offsets[vertex + 1] - block->offsets[vertex]),
+    };
+    return span;
+}
+
+/**
+ * @brief Pop edges of completed block from edge stack, build its local CSR and pass it to callback.
+ * @param search block search state
+ * @param edge_begin position of the first block edge on edge stack
+ * @param callback block callback
+ * @param context callback context
+ */
+void block_emit(block_search_t *search, uint64_t edge_begin, block_callback_t callback, void *context)
+{
+    block_t *block = &search->block;
+    uint32_t *edges = &search->edges[edge_begin * 2];
+    uint64_t edge_count = search->edge_count - edge_begin;
+    search->block_number++;
+
+    // number block vertices and count their degrees
+    block->node_count = 0;
+    for (uint64_t i = 0; i < edge_count * 2; i++)
+    {
+        uint32_t vertex = edges[i];
+        if (search->local_mark[vertex] != search->block_number)
+        {
+            search->local_mark[vertex] = search->block_number;
+            search->local_vertex[vertex] = block->node_count;
+            block->vertices[block->node_count] = vertex;
+            block->offsets[++block->node_count] = 0;
+        }
+        block->offsets[search->local_vertex[vertex] + 1]++;
+    }
+    block->offsets[0] = 0;
+    for (uint32_t i = 0; i < block->node_count; i++)
+    {
+        block->offsets[i + 1] += block->offsets[i];
+    }
+
+    // fill neighbors, offsets are shifted by one vertex during fill and restored afterwards
+    for (uint64_t i = 0; i < edge_count; i++)
+    {
+        uint32_t u = search->local_vertex[edges[i * 2]];
+        uint32_t v = search->local_vertex[edges[i * 2 + 1]];
+        block->neighbors[block->offsets[u]++] = v;
+        block->neighbors[block->offsets[v]++] = u;
+    }
+    for (uint32_t i = block->node_count; i > 0; i--)
+    {
+        block->offsets[i] = block->offsets[i - 1];
+    }
+    block->offsets[0] = 0;
+    block->edge_count = edge_count;
+
+    search->edge_count = edge_begin;
+    callback(block, context);
+}
+
+/**
+ * @brief Push edge to edge stack.
+ * @param search block search state
+ * @param u first vertex
+ * @param v second vertex
+ */
+void block_push_edge(block_search_t *search, uint32_t u, uint32_t v)
+{
+    search->edges[search->edge_count * 2] = u;
+    search->edges[search->edge_count * 2 + 1] = v;
+    search->edge_count++;
+}
+
+/**
+ * @brief Decompose graph to biconnected components (blocks) with Tarjan's algorithm and call callback for each of them.
+ *  DFS runs on an explicit frame stack, so deep graphs do not overflow the call stack.
+ *  Vertex v with DFS parent p closes a block when nothing below v reaches above p (low[v] >= discovery[p]),
+ *  the block consists of edges pushed since edge (p,v).
+ *
+ * Time complexity: O(|V|+|E|), memory O(|V|+|E|)
+ * @param callback block callback
+ * @param context callback context
+ */
+void graph_for_each_block(block_callback_t callback, void *context)
+{
+    uint32_t node_count = graph_get_node_count();
+    uint64_t edge_count = graph_get_arc_count() / 2;
+
+    block_search_t search = {0};
+    search.discovery = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+    search.low = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+    search.parent = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+    search.frames = (block_frame_t *)alloc(node_count, sizeof(block_frame_t));
+    search.edges = (uint32_t *)alloc(edge_count ? edge_count * 2 : 1, sizeof(uint32_t));
+    search.local_vertex = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+    search.local_mark = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+    search.block.offsets = (uint64_t *)alloc((size_t)node_count + 1, sizeof(uint64_t));
+    search.block.neighbors = (uint32_t *)alloc(edge_count ? edge_count * 2 : 1, sizeof(uint32_t));
+    search.block.vertices = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+
+    for (uint32_t root = 0; root < node_count; root++)
+    {
+        if (search.discovery[root])
+        {
+            continue;
+        }
+
+        search.discovery[root] = search.low[root] = ++search.time;
+        search.parent[root] = root;
+        search.frames[search.frame_count++] = (block_frame_t){.vertex = root, .cursor = 0};
+
+        while (search.frame_count)
+        {
+            block_frame_t *frame = &search.frames[search.frame_count - 1];
+            uint32_t vertex = frame->vertex;
+            vertex_span_t neighbors = graph_get_vertex_neighbors(vertex);
+
+            if (frame->cursor < neighbors.count)
+            {
+                uint32_t neighbor = neighbors.ids[frame->cursor++];
+
+                if (!search.discovery[neighbor])
+                {
+                    // tree edge, descend
+                    block_push_edge(&search, vertex, neighbor);
+                    search.discovery[neighbor] = search.low[neighbor] = ++search.time;
+                    search.parent[neighbor] = vertex;
+                    search.frames[search.frame_count++] = (block_frame_t){.vertex = neighbor, .cursor = 0};
+                }
+                else if (neighbor != search.parent[vertex] && search.discovery[neighbor] < search.discovery[vertex])
+                {
+                    // back edge to ancestor
+                    block_push_edge(&search, vertex, neighbor);
+                    if (search.discovery[neighbor] < search.low[vertex])
+                    {
+                        search.low[vertex] = search.discovery[neighbor];
+                    }
+                }
+                continue;
+            }
+
+            // all neighbors searched, return to parent
+            search.frame_count--;
+            if (vertex == root)
+            {
+                continue;
+            }
+
+            uint32_t parent = search.parent[vertex];
+            if (search.low[vertex] < search.low[parent])
+            {
+                search.low[parent] = search.low[vertex];
+            }
+            if (search.low[vertex] >= search.discovery[parent])
+            {
+                // edge (parent,vertex) is the first edge of the block on edge stack
+                uint64_t edge_begin = search.edge_count;
+                do
+                {
+                    edge_begin--;
+                } while (search.edges[edge_begin * 2] != parent || search.edges[edge_begin * 2 + 1] != vertex);
+                block_emit(&search, edge_begin, callback, context);
+            }
+        }
+    }
+
+    alloc_free(search.discovery);
+    alloc_free(search.low);
+    alloc_free(search.parent);
+    alloc_free(search.frames);
+    alloc_free(search.edges);
+    alloc_free(search.local_vertex);
+    alloc_free(search.local_mark);
+    alloc_free(search.block.offsets);
+    alloc_free(search.block.neighbors);
+    alloc_free(search.block.vertices);
+}
@@ -0,0 +1,723 @@
+/**
+ * @file cycles.c
+ * @authors Marek Gergel (xgerge01), Jindřich Šíma (xsimaj04)
+ * @brief definition of functions and variables for counting simple cycles of graph,
+ * Johnson's cycle enumeration for sparse graphs and subset dynamic programming for small dense graphs
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../include/cycles.h"
+#include "../include/thread_pool.h"
+#include "../include/stats.h"
+
+// blocks with at least this many vertices are searched by multiple threads
+#define CYCLE_PARALLEL_MIN_NODE_COUNT 16
+
+// end of blocked list marker
+#define ARC_NONE UINT64_MAX
+
+/**
+ * @brief Vertex on path of cycle search with its neighbors and position of the next searched neighbor.
+ */
+typedef struct cycle_search_frame
+{
+	vertex_span_t neighbors;
+	uint32_t vertex;
+	uint32_t cursor;
+	// path back to start vertex was found from vertex
+	bool cycle_found;
+} cycle_search_frame_t;
+
+/**
+ * @brief State of Johnson's simple cycle search, reused for all start vertices.
+ * Vertex arrays are indexed by vertex, arc arrays by arc (position in graph CSR neighbor arrays).
+ * Blocked list B(w) holds arcs (v,w) of blocked vertices v waiting for w to be unblocked.
+ */
+typedef struct cycle_search
+{
+	const block_t *block;
+	uint32_t start_vertex;
+	uint32_t path_length;
+	// searched path, path_length frames are used
+	cycle_search_frame_t *path;
+	// vertices whose blocked lists are still to be unblocked
+	uint32_t *unblocked;
+	// count of cycles found in both directions by length
+	uint64_t *length_counts;
+	// vertex arrays
+	bool *blocked;
+	uint64_t *blocked_head;
+	uint32_t *touched_mark;
+	uint32_t *touched;
+	uint32_t touched_count;
+	// arc arrays
+	uint64_t *blocked_next;
+	uint32_t *blocked_source;
+	bool *arc_blocked;
+} cycle_search_t;
+
+/**
+ * @brief Allocate zeroed cycle counts for cycles up to max_length.
+ * @param counts cycle counts to initialize
+ * @param max_length maximal cycle length
+ */
+void cycle_counts_init(cycle_counts_t *counts, uint32_t max_length)
+{
+	counts->total = 0;
+	counts->max_length = max_length;
+	counts->by_length = (uint64_t *)alloc((size_t)max_length + 1, sizeof(uint64_t));
+}
+
+/**
+ * @brief Free cycle counts.
+ * @param counts cycle counts
+ */
+void cycle_counts_destroy(cycle_counts_t *counts)
+{
+	alloc_free(counts->by_length);
+	counts->by_length = NULL;
+}
+
+/**
+ * @brief Add cycles found in both directions to counts, each of them is counted once.
+ * @param counts cycle counts
+ * @param directed_counts counts of cycles by length, found in both directions
+ * @param max_length maximal length in directed_counts
+ */
+void cycle_counts_add_directed(cycle_counts_t *counts, const uint64_t *directed_counts, uint32_t max_length)
+{
+	for (uint32_t length = 3; length <= max_length && length <= counts->max_length; length++)
+	{
+		counts->by_length[length] += directed_counts[length] / 2;
+		counts->total += directed_counts[length] / 2;
+	}
+}
+
+/**
+ * @brief Unblock vertex and all vertices waiting for it in its blocked list, transitively.
+ * Vertices are unblocked when they are reached and their blocked lists are emptied from explicit stack.
+ * @param search cycle search state
+ * @param vertex vertex to unblock
+ */
+void cycle_search_unblock(cycle_search_t *search, uint32_t vertex)
+{
+	uint32_t unblocked_count = 0;
+	search->blocked[vertex] = false;
+	search->unblocked[unblocked_count++] = vertex;
+
+	while (unblocked_count != 0)
+	{
+		uint32_t unblocked_vertex = search->unblocked[--unblocked_count];
+		uint64_t arc = search->blocked_head[unblocked_vertex];
+		search->blocked_head[unblocked_vertex] = ARC_NONE;
+
+		while (arc != ARC_NONE)
+		{
+			uint64_t next_arc = search->blocked_next[arc];
+			uint32_t waiting_vertex = search->blocked_source[arc];
+			search->arc_blocked[arc] = false;
+
+			if (search->blocked[waiting_vertex])
+			{
+				search->blocked[waiting_vertex] = false;
+				search->unblocked[unblocked_count++] = waiting_vertex;
+			}
+			arc = next_arc;
+		}
+	}
+}
+
+/**
+ * @brief Push vertex to path of cycle search and block it.
+ * @param search cycle search state
+ * @param vertex pushed vertex
+ * @return vertex_span_t neighbors of pushed vertex
+ */
+vertex_span_t cycle_search_push(cycle_search_t *search, uint32_t vertex)
+{
+	if (search->touched_mark[vertex] != search->start_vertex + 1)
+	{
+		search->touched_mark[vertex] = search->start_vertex + 1;
+		search->touched[search->touched_count++] = vertex;
+	}
+
+	search->path[search->path_length++].vertex = vertex;
+	search->blocked[vertex] = true;
+	STATS_ENTER();
+
+	vertex_span_t neighbors = block_get_neighbors(search->block, vertex);
+	STATS_ADD(vertexVisitsCounter, 1);
+	STATS_ADD(edgeRelaxationsCounter, neighbors.count);
+	return neighbors;
+}
+
+/**
+ * @brief Pop vertex from path of cycle search. Vertex which reached start vertex is unblocked,
+ * other vertex stays blocked until any of its neighbors gets unblocked.
+ * @param search cycle search state
+ * @param vertex the last vertex of path
+ * @param neighbors neighbors of the vertex
+ * @param cycle_found path from the vertex back to start vertex was found
+ */
+void cycle_search_pop(cycle_search_t *search, uint32_t vertex, vertex_span_t neighbors, bool cycle_found)
+{
+	if (cycle_found)
+	{
+		cycle_search_unblock(search, vertex);
+	}
+	else
+	{
+		// vertex stays blocked until any of its neighbors gets unblocked
+		uint64_t arc = search->block->offsets[vertex];
+		for (uint32_t i = 0; i < neighbors.count; i++, arc++)
+		{
+			uint32_t neighbor = neighbors.ids[i];
+			if (neighbor > search->start_vertex && !search->arc_blocked[arc])
+			{
+				search->arc_blocked[arc] = true;
+				search->blocked_source[arc] = vertex;
+				search->blocked_next[arc] = search->blocked_head[neighbor];
+				search->blocked_head[neighbor] = arc;
+			}
+		}
+	}
+
+	// pop vertex from path
+	search->path_length--;
+	STATS_LEAVE();
+}
+
+/**
+ * @brief Get all simple cycles through start vertex with Johnson's circuit search.
+ *  Only vertices with index greater or equal to start vertex are searched, so every cycle
+ *  is found only from its lowest vertex. Undirected cycle is found once in each direction.
+ *  Vertex stays blocked while it can not reach start vertex, so every dead end is searched once per cycle found.
+ *  Path is kept on explicit stack, so its length is not limited by thread stack, state of the last vertex
+ *  is kept in locals and stored to its frame only while its neighbor is searched.
+ * @param search cycle search state
+ * @param vertex vertex to be searched
+ * @return bool path from vertex back to start vertex was found
+ */
+bool search_all_cycles(cycle_search_t *search, uint32_t vertex)
+{
+	uint32_t start_vertex = search->start_vertex;
+	const bool *blocked = search->blocked;
+	uint32_t base_length = search->path_length;
+	vertex_span_t neighbors = cycle_search_push(search, vertex);
+	uint32_t cursor = 0;
+	bool cycle_found = false;
+
+	while (true)
+	{
+		// go through remaining neighbors, unblocked neighbor is pushed to path and searched first
+		while (cursor < neighbors.count)
+		{
+			uint32_t neighbor = neighbors.ids[cursor++];
+
+			if (neighbor == start_vertex)
+			{
+				// cycle must be of at least 3 vertices, path back over the same edge only marks the way to start
+				if (search->path_length > 2)
+				{
+					search->length_counts[search->path_length]++;
+				}
+				cycle_found = true;
+			}
+			else if (neighbor > start_vertex && !blocked[neighbor])
+			{
+				cycle_search_frame_t *frame = &search->path[search->path_length - 1];
+				frame->neighbors = neighbors;
+				frame->cursor = cursor;
+				frame->cycle_found = cycle_found;
+				neighbors = cycle_search_push(search, neighbor);
+				vertex = neighbor;
+				cursor = 0;
+				cycle_found = false;
+			}
+		}
+
+		cycle_search_pop(search, vertex, neighbors, cycle_found);
+		if (search->path_length == base_length)
+		{
+			return cycle_found;
+		}
+
+		// continue with the previous vertex of path
+		cycle_search_frame_t *frame = &search->path[search->path_length - 1];
+		vertex = frame->vertex;
+		neighbors = frame->neighbors;
+		cursor = frame->cursor;
+		cycle_found |= frame->cycle_found;
+	}
+}
+
+/**
+ * @brief Count cycles through start vertex using vertices with greater index only,
+ * search state is cleaned for vertices touched by the search afterwards.
+ * @param search cycle search state
+ * @param start_vertex lowest vertex of counted cycles
+ */
+void cycle_search_from(cycle_search_t *search, uint32_t start_vertex)
+{
+	// cycle needs at least 2 neighbors with greater index
+	vertex_span_t neighbors = block_get_neighbors(search->block, start_vertex);
+	uint32_t greater_neighbors = 0;
+	for (uint32_t i = 0; i < neighbors.count && greater_neighbors < 2; i++)
+	{
+		greater_neighbors += neighbors.ids[i] > start_vertex;
+	}
+	if (greater_neighbors < 2)
+	{
+		return;
+	}
+
+	search->start_vertex = start_vertex;
+	search->path_length = 0;
+	search->touched_count = 0;
+
+	search_all_cycles(search, start_vertex);
+
+	for (uint32_t i = 0; i < search->touched_count; i++)
+	{
+		uint32_t vertex = search->touched[i];
+		search->blocked[vertex] = false;
+		for (uint64_t arc = search->blocked_head[vertex]; arc != ARC_NONE; arc = search->blocked_next[arc])
+		{
+			search->arc_blocked[arc] = false;
+		}
+		search->blocked_head[vertex] = ARC_NONE;
+	}
+}
+
+/**
+ * @brief Allocate cycle search state for block.
+ * @param search cycle search state to initialize
+ * @param block searched block
+ */
+void cycle_search_init(cycle_search_t *search, const block_t *block)
+{
+	uint32_t node_count = block->node_count;
+	uint64_t arc_count = block->edge_count * 2;
+
+	search->block = block;
+	search->path = (cycle_search_frame_t *)alloc(node_count, sizeof(cycle_search_frame_t));
+	search->unblocked = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	search->length_counts = (uint64_t *)alloc((size_t)node_count + 1, sizeof(uint64_t));
+	search->blocked = (bool *)alloc(node_count, sizeof(bool));
+	search->blocked_head = (uint64_t *)alloc(node_count, sizeof(uint64_t));
+	search->touched_mark = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	search->touched = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	search->blocked_next = (uint64_t *)alloc(arc_count ? arc_count : 1, sizeof(uint64_t));
+	search->blocked_source = (uint32_t *)alloc(arc_count ? arc_count : 1, sizeof(uint32_t));
+	search->arc_blocked = (bool *)alloc(arc_count ? arc_count : 1, sizeof(bool));
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		search->blocked_head[i] = ARC_NONE;
+	}
+}
+
+/**
+ * @brief Free cycle search state.
+ * @param search cycle search state
+ */
+void cycle_search_destroy(cycle_search_t *search)
+{
+	alloc_free(search->path);
+	alloc_free(search->unblocked);
+	alloc_free(search->length_counts);
+	alloc_free(search->blocked);
+	alloc_free(search->blocked_head);
+	alloc_free(search->touched_mark);
+	alloc_free(search->touched);
+	alloc_free(search->blocked_next);
+	alloc_free(search->blocked_source);
+	alloc_free(search->arc_blocked);
+}
+
+/**
+ * @brief Thread pool task, counts cycles with lowest vertex equal to task index in worker own search state.
+ * @param context array of cycle search states, one per worker
+ * @param worker_index index of the worker
+ * @param task_index start vertex
+ */
+void cycle_search_task(void *context, unsigned int worker_index, uint64_t task_index)
+{
+	cycle_search_t *searches = (cycle_search_t *)context;
+	cycle_search_from(&searches[worker_index], (uint32_t)task_index);
+}
+
+/**
+ * @brief Count all simple cycles in block with Johnson's algorithm.
+ * Every cycle is searched from its lowest vertex and found once in each direction.
+ * Start vertices are independent, so they are searched in parallel by thread_count workers,
+ * each with its own search state and counters.
+ *
+ * Time complexity: O((|V|+|E|)(C+1)), C = number of cycles, memory O(|V|+|E|) per thread
+ * @param block searched block
+ * @param thread_count count of worker threads
+ * @param counts cycle counts, cycles are added to it
+ */
+void cycles_count_johnson(const block_t *block, unsigned int thread_count, cycle_counts_t *counts)
+{
+	uint32_t node_count = block->node_count;
+	unsigned int worker_count = thread_count < node_count ? thread_count : node_count;
+
+	cycle_search_t *searches = (cycle_search_t *)alloc(worker_count, sizeof(cycle_search_t));
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		cycle_search_init(&searches[i], block);
+	}
+
+	thread_pool_run(worker_count, node_count, cycle_search_task, searches);
+
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		cycle_counts_add_directed(counts, searches[i].length_counts, node_count);
+		cycle_search_destroy(&searches[i]);
+	}
+	alloc_free(searches);
+}
+
+/**
+ * @brief Context of subset DP cycle counting shared by all tasks.
+ */
+typedef struct subset_dp
+{
+	uint32_t node_count;
+	// adjacency[v] has bit u set when there is edge (v,u)
+	uint64_t *adjacency;
+	// count of cycles found in both directions by length, one array per worker
+	uint64_t **length_counts;
+} subset_dp_t;
+
+/**
+ * @brief Thread pool task, counts cycles with lowest vertex equal to task index.
+ *  paths[mask][j] is count of paths from start vertex through exactly the vertices of mask ending in vertex j,
+ *  vertices greater than start vertex are renumbered from 0. Masks only grow, so they are processed in increasing order.
+ *  Every path ending in neighbor of start vertex closes a cycle, which is found once in each direction.
+ * @param context subset DP context
+ * @param worker_index index of the worker
+ * @param task_index start vertex
+ */
+void subset_dp_task(void *context, unsigned int worker_index, uint64_t task_index)
+{
+	subset_dp_t *dp = (subset_dp_t *)context;
+	uint32_t start_vertex = (uint32_t)task_index;
+	uint32_t vertex_count = dp->node_count - start_vertex - 1;
+
+	// cycle needs at least 2 other vertices
+	if (vertex_count < 2)
+	{
+		return;
+	}
+
+	uint64_t *length_counts = dp->length_counts[worker_index];
+	uint64_t start_neighbors = dp->adjacency[start_vertex] >> (start_vertex + 1);
+	uint64_t neighbors[CYCLE_DP_MAX_NODE_COUNT];
+	for (uint32_t j = 0; j < vertex_count; j++)
+	{
+		neighbors[j] = dp->adjacency[start_vertex + 1 + j] >> (start_vertex + 1);
+	}
+
+	uint64_t mask_count = (uint64_t)1 << vertex_count;
+	uint64_t *paths = (uint64_t *)alloc(mask_count * vertex_count, sizeof(uint64_t));
+
+	for (uint64_t bits = start_neighbors; bits; bits &= bits - 1)
+	{
+		uint32_t j = (uint32_t)__builtin_ctzll(bits);
+		paths[((uint64_t)1 << j) * vertex_count + j] = 1;
+	}
+
+	for (uint64_t mask = 1; mask < mask_count; mask++)
+	{
+		uint32_t length = (uint32_t)__builtin_popcountll(mask) + 1;
+		uint64_t *mask_paths = &paths[mask * vertex_count];
+
+		for (uint64_t bits = mask; bits; bits &= bits - 1)
+		{
+			uint32_t j = (uint32_t)__builtin_ctzll(bits);
+			uint64_t path_count = mask_paths[j];
+			if (path_count == 0)
+			{
+				continue;
+			}
+
+			if (length > 2 && ((start_neighbors >> j) & 1))
+			{
+				length_counts[length] += path_count;
+			}
+
+			for (uint64_t next = neighbors[j] & ~mask; next; next &= next - 1)
+			{
+				uint32_t k = (uint32_t)__builtin_ctzll(next);
+				paths[(mask | ((uint64_t)1 << k)) * vertex_count + k] += path_count;
+			}
+		}
+	}
+
+	alloc_free(paths);
+}
+
+/**
+ * @brief Check if subset DP should be used for block instead of cycle enumeration.
+ * Number of cycles of dense graph grows factorially, DP cost depends on node count only.
+ * @param block searched block
+ * @return bool block is small and dense
+ */
+bool cycles_use_subset_dp(const block_t *block)
+{
+	uint32_t node_count = block->node_count;
+	if (node_count < 3 || node_count > CYCLE_DP_MAX_NODE_COUNT)
+	{
+		return false;
+	}
+	uint64_t max_edge_count = (uint64_t)node_count * (node_count - 1) / 2;
+	return (double)block->edge_count >= CYCLE_DP_MIN_DENSITY * (double)max_edge_count;
+}
+
+/**
+ * @brief Count all simple cycles in block with dynamic programming over vertex subsets,
+ * like Hamiltonian path counting from the lowest vertex of every cycle.
+ * Start vertices are independent, so they are counted in parallel by thread_count workers.
+ *
+ * Time complexity: O(2^|V| * |V|^2), memory O(2^|V| * |V|) per thread, independent of cycle count
+ * @param block searched block
+ * @param thread_count count of worker threads
+ * @param counts cycle counts, cycles are added to it
+ */
+void cycles_count_subset_dp(const block_t *block, unsigned int thread_count, cycle_counts_t *counts)
+{
+	uint32_t node_count = block->node_count;
+	if (node_count > CYCLE_DP_MAX_NODE_COUNT)
+	{
+		error_exit(internalError, "Subset DP cycle count is limited to %u nodes\n", CYCLE_DP_MAX_NODE_COUNT);
+	}
+	unsigned int worker_count = thread_count < node_count ? thread_count : node_count;
+
+	subset_dp_t dp = {
+		.node_count = node_count,
+		.adjacency = (uint64_t *)alloc(node_count ? node_count : 1, sizeof(uint64_t)),
+		.length_counts = (uint64_t **)alloc(worker_count ? worker_count : 1, sizeof(uint64_t *)),
+	};
+	for (uint32_t v = 0; v < node_count; v++)
+	{
+		vertex_span_t neighbors = block_get_neighbors(block, v);
+		for (uint32_t i = 0; i < neighbors.count; i++)
+		{
+			dp.adjacency[v] |= (uint64_t)1 << neighbors.ids[i];
+		}
+	}
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		dp.length_counts[i] = (uint64_t *)alloc((size_t)node_count + 1, sizeof(uint64_t));
+	}
+
+	thread_pool_run(worker_count, node_count, subset_dp_task, &dp);
+
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		cycle_counts_add_directed(counts, dp.length_counts[i], node_count);
+		alloc_free(dp.length_counts[i]);
+	}
+	alloc_free(dp.length_counts);
+	alloc_free(dp.adjacency);
+}
+
+/**
+ * @brief Small block collected for counting as one task, its arrays are stored at offsets_start
+ * and neighbors_start of shared arrays of collected blocks.
+ */
+typedef struct small_block
+{
+	uint32_t node_count;
+	uint64_t edge_count;
+	uint64_t offsets_start;
+	uint64_t neighbors_start;
+} small_block_t;
+
+/**
+ * @brief Context of cycle counting over all blocks of graph. Large blocks are counted when they are found,
+ * their start vertices are split among threads. Small blocks are copied and counted afterwards,
+ * each of them by one thread.
+ */
+typedef struct cycle_blocks
+{
+	unsigned int thread_count;
+	cycle_counts_t *counts;
+	// collected small blocks with their CSR arrays
+	small_block_t *small_blocks;
+	uint64_t small_block_count;
+	uint64_t small_block_capacity;
+	uint64_t *offsets;
+	uint64_t offset_count;
+	uint64_t offset_capacity;
+	uint32_t *neighbors;
+	uint64_t neighbor_count;
+	uint64_t neighbor_capacity;
+	// cycle counts of small blocks, one per worker
+	cycle_counts_t *worker_counts;
+} cycle_blocks_t;
+
+/**
+ * @brief Copy small block to collected blocks, arrays grow twice when they are full.
+ * @param blocks cycle blocks context
+ * @param block copied block
+ */
+void cycle_blocks_collect(cycle_blocks_t *blocks, const block_t *block)
+{
+	uint64_t offset_count = (uint64_t)block->node_count + 1;
+	uint64_t neighbor_count = block->edge_count * 2;
+	if (blocks->small_block_count == blocks->small_block_capacity)
+	{
+		blocks->small_block_capacity = blocks->small_block_capacity ? blocks->small_block_capacity * 2 : 64;
+		blocks->small_blocks = (small_block_t *)alloc_resize(blocks->small_blocks, (size_t)blocks->small_block_capacity, sizeof(small_block_t));
+	}
+	if (blocks->offset_count + offset_count > blocks->offset_capacity)
+	{
+		while (blocks->offset_count + offset_count > blocks->offset_capacity)
+		{
+			blocks->offset_capacity = blocks->offset_capacity ? blocks->offset_capacity * 2 : 1024;
+		}
+		blocks->offsets = (uint64_t *)alloc_resize(blocks->offsets, (size_t)blocks->offset_capacity, sizeof(uint64_t));
+	}
+	if (blocks->neighbor_count + neighbor_count > blocks->neighbor_capacity)
+	{
+		while (blocks->neighbor_count + neighbor_count > blocks->neighbor_capacity)
+		{
+			blocks->neighbor_capacity = blocks->neighbor_capacity ? blocks->neighbor_capacity * 2 : 4096;
+		}
+		blocks->neighbors = (uint32_t *)alloc_resize(blocks->neighbors, (size_t)blocks->neighbor_capacity, sizeof(uint32_t));
+	}
+
+	blocks->small_blocks[blocks->small_block_count++] = (small_block_t){
+		.node_count = block->node_count,
+		.edge_count = block->edge_count,
+		.offsets_start = blocks->offset_count,
+		.neighbors_start = blocks->neighbor_count,
+	};
+	memcpy(&blocks->offsets[blocks->offset_count], block->offsets, (size_t)offset_count * sizeof(uint64_t));
+	memcpy(&blocks->neighbors[blocks->neighbor_count], block->neighbors, (size_t)neighbor_count * sizeof(uint32_t));
+	blocks->offset_count += offset_count;
+	blocks->neighbor_count += neighbor_count;
+}
+
+/**
+ * @brief Count cycles of block with engine fitting the block.
+ * @param block counted block
+ * @param thread_count count of threads which split start vertices of the block
+ * @param counts cycle counts, cycles are added to it
+ */
+void cycles_count_in_block(const block_t *block, unsigned int thread_count, cycle_counts_t *counts)
+{
+	if (cycles_use_subset_dp(block))
+	{
+		cycles_count_subset_dp(block, thread_count, counts);
+	}
+	else
+	{
+		cycles_count_johnson(block, thread_count, counts);
+	}
+}
+
+/**
+ * @brief Thread pool task, counts cycles of one collected small block to worker own counts.
+ * @param context cycle blocks context
+ * @param worker_index index of the worker
+ * @param task_index index of collected block
+ */
+void small_block_task(void *context, unsigned int worker_index, uint64_t task_index)
+{
+	cycle_blocks_t *blocks = (cycle_blocks_t *)context;
+	const small_block_t *small_block = &blocks->small_blocks[task_index];
+	block_t block = {
+		.node_count = small_block->node_count,
+		.edge_count = small_block->edge_count,
+		.offsets = &blocks->offsets[small_block->offsets_start],
+		.neighbors = &blocks->neighbors[small_block->neighbors_start],
+		.vertices = NULL,
+	};
+	cycles_count_in_block(&block, 1, &blocks->worker_counts[worker_index]);
+}
+
+/**
+ * @brief Block callback, counts cycles of large block or collects small block.
+ *  Block with less than 3 vertices is a bridge without cycles. Block with cyclomatic number
+ *  |E| - |V| + 1 equal to 1 is a single cycle through all its vertices.
+ * @param block counted block
+ * @param context cycle blocks context
+ */
+void cycles_count_block(const block_t *block, void *context)
+{
+	cycle_blocks_t *blocks = (cycle_blocks_t *)context;
+
+	if (block->node_count < 3)
+	{
+		return;
+	}
+	if (block->edge_count == block->node_count)
+	{
+		blocks->counts->by_length[block->node_count]++;
+		blocks->counts->total++;
+		return;
+	}
+
+	if (block->node_count >= CYCLE_PARALLEL_MIN_NODE_COUNT || blocks->thread_count == 1)
+	{
+		cycles_count_in_block(block, blocks->thread_count, blocks->counts);
+	}
+	else
+	{
+		cycle_blocks_collect(blocks, block);
+	}
+}
+
+/**
+ * @brief Count all simple cycles in graph. Every cycle lies in one biconnected component,
+ * so cycles are counted in each block separately, small dense blocks with subset DP, others with Johnson's algorithm.
+ * Start vertices of large blocks are split among threads, small blocks are counted in parallel as whole tasks.
+ *
+ * Time complexity: O(|V|+|E|) decomposition plus cost of engine for every block with more than one cycle
+ * @param thread_count count of worker threads
+ * @param counts cycle counts initialized for |V| length, cycles are added to it
+ */
+void cycles_count(unsigned int thread_count, cycle_counts_t *counts)
+{
+	cycle_blocks_t blocks = {
+		.thread_count = thread_count ? thread_count : 1,
+		.counts = counts,
+	};
+	graph_for_each_block(cycles_count_block, &blocks);
+	if (blocks.small_block_count == 0)
+	{
+		return;
+	}
+
+	// cycles of small blocks are shorter than CYCLE_PARALLEL_MIN_NODE_COUNT
+	unsigned int worker_count = blocks.thread_count < blocks.small_block_count ? blocks.thread_count : (unsigned int)blocks.small_block_count;
+	uint32_t max_length = counts->max_length < CYCLE_PARALLEL_MIN_NODE_COUNT ? counts->max_length : CYCLE_PARALLEL_MIN_NODE_COUNT;
+	blocks.worker_counts = (cycle_counts_t *)alloc(worker_count, sizeof(cycle_counts_t));
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		cycle_counts_init(&blocks.worker_counts[i], max_length);
+	}
+
+	thread_pool_run(worker_count, blocks.small_block_count, small_block_task, &blocks);
+
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		for (uint32_t length = 3; length <= max_length; length++)
+		{
+			counts->by_length[length] += blocks.worker_counts[i].by_length[length];
+		}
+		counts->total += blocks.worker_counts[i].total;
+		cycle_counts_destroy(&blocks.worker_counts[i]);
+	}
+	alloc_free(blocks.worker_counts);
+	alloc_free(blocks.small_blocks);
+	alloc_free(blocks.offsets);
+	alloc_free(blocks.neighbors);
+}
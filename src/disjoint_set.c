@@ -0,0 +1,105 @@
+/**
+ * @file disjoint_set.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for disjoint set forest (union-find) of graph vertices,
+ * with path compression and union by rank every operation takes amortized O(α(|V|)) time
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../include/disjoint_set.h"
+#include "../include/graph.h"
+
+/**
+ * @brief Function initializes empty disjoint set forest.
+ * @param set disjoint set structure pointer
+ */
+void disjoint_set_init(disjoint_set_t *set)
+{
+    set->count = 0;
+    set->capacity = 0;
+    set->set_count = 0;
+    set->parent = NULL;
+    set->rank = NULL;
+}
+
+/**
+ * @brief Function frees disjoint set forest.
+ * @param set disjoint set structure pointer
+ */
+void disjoint_set_destroy(disjoint_set_t *set)
+{
+    alloc_free(set->parent);
+    alloc_free(set->rank);
+    disjoint_set_init(set);
+}
+
+/**
+ * @brief Function adds new item in its own set.
+ * @param set disjoint set structure pointer
+ * @return uint32_t index of the new item
+ */
+uint32_t disjoint_set_add(disjoint_set_t *set)
+{
+    if (set->count == set->capacity)
+    {
+        set->capacity = set->capacity ? set->capacity * 2 : 16;
+        set->parent = (uint32_t *)alloc_resize(set->parent, set->capacity, sizeof(uint32_t));
+        set->rank = (uint8_t *)alloc_resize(set->rank, set->capacity, sizeof(uint8_t));
+    }
+    set->parent[set->count] = set->count;
+    set->rank[set->count] = 0;
+    set->set_count++;
+    return set->count++;
+}
+
+/**
+ * @brief Function finds representative item of the set containing item,
+ * every visited item is linked to its grandparent (path halving).
+ * @param set disjoint set structure pointer
+ * @param item item index
+ * @return uint32_t representative item index
+ */
+uint32_t disjoint_set_find(disjoint_set_t *set, uint32_t item)
+{
+    while (set->parent[item] != item)
+    {
+        set->parent[item] = set->parent[set->parent[item]];
+        item = set->parent[item];
+    }
+    return item;
+}
+
+/**
+ * @brief Function merges sets containing both items, tree with lower rank is linked under the other one.
+ * @param set disjoint set structure pointer
+ * @param item first item index
+ * @param item2 second item index
+ * @return bool sets were merged, false when both items were already in the same set
+ */
+bool disjoint_set_union(disjoint_set_t *set, uint32_t item, uint32_t item2)
+{
+    uint32_t root = disjoint_set_find(set, item);
+    uint32_t root2 = disjoint_set_find(set, item2);
+    if (root == root2)
+    {
+        return false;
+    }
+
+    if (set->rank[root] < set->rank[root2])
+    {
+        uint32_t swap = root;
+        root = root2;
+        root2 = swap;
+    }
+    set->parent[root2] = root;
+    if (set->rank[root] == set->rank[root2])
+    {
+        set->rank[root]++;
+    }
+    set->set_count--;
+    return true;
+}
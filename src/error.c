@@ -10,9 +10,11 @@
  */
 
 #include "../include/error.h"
+#include "../include/graph_ctx.h"
 
 /**
  * @brief Prints an error message, free used memory and exits the program.
+ * When library call runs on calling thread, error is stored to its context and the call returns instead.
  *
  * @param errcode error exit code
  * @param msg message to print
@@ -20,6 +22,11 @@
  */
 void error_exit(errorCodes_t errcode, char *msg, ...)
 {
+    va_list call_args;
+    va_start(call_args, msg);
+    graph_ctx_fail(errcode, msg, call_args);
+    va_end(call_args);
+
     fflush(stdout);
     fflush(stderr);
     va_list args;
@@ -32,18 +39,20 @@ void error_exit(errorCodes_t errcode, char *msg, ...)
 }
 
 /**
- * @brief Prints a warning message.
+ * @brief Prints a warning message to warning output of bound graph context.
  *
  * @param msg message to print
  * @param ... message arguments
  */
 void warning_print(char *msg, ...)
 {
+    FILE *stream = graph_ctx_current()->warning_output;
+    stream = stream ? stream : stderr;
     fflush(stdout);
     fflush(stderr);
     va_list args;
     va_start(args, msg);
-    fprintf(stderr, "Warning: ");
-    vfprintf(stderr, msg, args);
+    fprintf(stream, "Warning: ");
+    vfprintf(stream, msg, args);
     va_end(args);
 }
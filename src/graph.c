@@ -9,38 +9,283 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/mman.h>
+#include <inttypes.h>
 #include "../include/graph.h"
+#include "../include/graph_ctx.h"
+#include "../include/arena.h"
+#include "../include/disjoint_set.h"
+#include "../include/bitset.h"
+#include "../include/stats.h"
+#include "../include/memory_usage.h"
 
-struct node
+/**
+ * Name index slot, node index + 1 (0 is empty slot), upper half of name hash and position of the name
+ * in name pool, so probing skips other names without reading the name pool and found name is compared
+ * without reading name offsets.
+ */
+typedef struct name_slot
 {
-    char *name;
-    unsigned int edge_count;
-    node_t *edge_nodes[MAX_NODE_EDGE_COUNT];
-};
+    uint32_t node;
+    uint32_t hash;
+    // name offset << NAME_SLOT_LENGTH_BITS | name length, longer names store NAME_SLOT_LENGTH_MASK
+    uint64_t name;
+} name_slot_t;
 
+#define NAME_SLOT_LENGTH_BITS 16
+#define NAME_SLOT_LENGTH_MASK ((1ULL << NAME_SLOT_LENGTH_BITS) - 1)
+
+/**
+ * Graph is stored in compressed sparse row (CSR) format after finalization.
+ * Neighbors of node i are edge_nodes[edge_offsets[i]] .. edge_nodes[edge_offsets[i + 1] - 1],
+ * so memory scales with |V| + |E| and traversals walk contiguous arrays.
+ * Nodes are stored as arrays of their fields and all graph memory (including this structure)
+ * is allocated from one arena, so the graph is destroyed by releasing the arena.
+ */
 typedef struct graph
 {
+    arena_t arena;
     unsigned int node_count;
-    node_t *nodes[MAX_NODE_COUNT];
+    unsigned int node_capacity;
+    // node degrees, counted while streaming and by graph_finalize otherwise
+    uint32_t *degrees;
+    uint64_t edge_count;
+    // open addressing hash index of node names
+    name_slot_t *name_index;
+    size_t name_index_capacity;
+    bool finalized;
+    uint64_t *edge_offsets;
+    uint32_t *edge_nodes;
+    // build phase edges, (smaller index << 32 | larger index) in creation order, sorted by graph_finalize,
+    // edges which may come in both directions are stored as (index << 32 | index 2)
+    uint64_t *edge_pairs;
+    uint64_t edge_pair_count;
+    uint64_t edge_pair_capacity;
+    bool mirrored_edges;
+    // adjacency matrix of dense graph, row-major bitset built from CSR arrays on first request
+    uint64_t *matrix;
+    size_t matrix_row_words;
+    // streaming mode, edges are not stored, only merged into components
+    bool streaming;
+    disjoint_set_t components;
+    bool streamed_cycle;
+    // binary graph, CSR arrays and names point into storage
+    void *storage;
+    size_t storage_length;
+    bool storage_mapped;
+    // string pool of null terminated node names, name of node i starts at names[name_offsets[i]],
+    // name_offsets[node_count] is pool length
+    uint64_t *name_offsets;
+    char *names;
+    uint64_t names_capacity;
+    // numbered graph, nodes are named by index + first_number and have no name index
+    bool numbered;
+    unsigned int first_number;
 } graph_t;
 
-graph_t *graph = NULL;
+// size of buffer for decimal name of numbered node
+#define NUMBER_NAME_SIZE 12
+// count of duplicate edges shown in warning
+#define DUPLICATE_EDGE_EXAMPLE_COUNT 5
+// bits of radix sort digit
+#define RADIX_BITS 11
+
+/**
+ * @brief Internal function returns size of n elements.
+ * @throw Error when size overflows.
+ * @param n number of elements
+ * @param size size of each element
+ * @return size_t size in bytes
+ */
+size_t alloc_bytes(size_t n, size_t size)
+{
+    if (size != 0 && n > (SIZE_MAX - ALLOC_HEADER_SIZE) / size)
+    {
+        error_exit(internalError, "Memory allocation failed\n");
+    }
+    return n * size;
+}
 
 /**
- * @brief Internal allocation function with zeroing and error checking.
+ * @brief Internal allocation function with zeroing and error checking. Memory is preceded by block header,
+ * so it is counted to memory usage of bound graph context until it is released by alloc_free
+ * and it is freed when call which allocated it fails.
  * In case of error exits the program with error code internalError.
+ * @throw Error when memory limit of bound graph context is exceeded.
  * @param n number of elements to allocate
  * @param size size of each element
  * @return void* pointer to the allocated memory
  */
 void *alloc(size_t n, size_t size)
 {
-    void *ptr = calloc(n, size);
+    size_t bytes = alloc_bytes(n, size);
+    memory_usage_allocate(bytes);
+    memory_block_t *block = (memory_block_t *)calloc(1, ALLOC_HEADER_SIZE + bytes);
+    if (!block)
+    {
+        memory_usage_release(bytes);
+        error_exit(internalError, "Memory allocation failed\n");
+    }
+    block->size = bytes;
+    memory_block_attach(block);
+    return (char *)block + ALLOC_HEADER_SIZE;
+}
+
+/**
+ * @brief Internal reallocation function with error checking, new memory is not zeroed.
+ * In case of error exits the program with error code internalError.
+ * @throw Error when memory limit of bound graph context is exceeded.
+ * @param ptr pointer to the memory allocated by alloc or NULL
+ * @param n new number of elements
+ * @param size size of each element
+ * @return void* pointer to the reallocated memory
+ */
+void *alloc_resize(void *ptr, size_t n, size_t size)
+{
     if (!ptr)
     {
+        return alloc(n, size);
+    }
+    size_t bytes = alloc_bytes(n, size);
+    memory_block_t *block = (memory_block_t *)((char *)ptr - ALLOC_HEADER_SIZE);
+    size_t old_bytes = block->size;
+    if (bytes > old_bytes)
+    {
+        memory_usage_allocate(bytes - old_bytes);
+    }
+    memory_block_detach(block);
+    memory_block_t *new_block = (memory_block_t *)realloc(block, ALLOC_HEADER_SIZE + bytes);
+    if (!new_block)
+    {
+        memory_block_attach(block);
+        if (bytes > old_bytes)
+        {
+            memory_usage_release(bytes - old_bytes);
+        }
         error_exit(internalError, "Memory allocation failed\n");
     }
-    return ptr;
+    if (bytes < old_bytes)
+    {
+        memory_usage_release(old_bytes - bytes);
+    }
+    new_block->size = bytes;
+    memory_block_attach(new_block);
+    return (char *)new_block + ALLOC_HEADER_SIZE;
+}
+
+/**
+ * @brief Internal function releases memory allocated by alloc or alloc_resize.
+ * @param ptr pointer to the memory or NULL
+ */
+void alloc_free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    memory_block_t *block = (memory_block_t *)((char *)ptr - ALLOC_HEADER_SIZE);
+    memory_block_detach(block);
+    memory_usage_release(block->size);
+    free(block);
+}
+
+/**
+ * @brief Internal function marks memory allocated by alloc as kept by bound graph context,
+ * so it is not freed when the call which allocated it fails.
+ * @param ptr pointer to the memory
+ */
+void alloc_keep(void *ptr)
+{
+    memory_block_keep((memory_block_t *)((char *)ptr - ALLOC_HEADER_SIZE));
+}
+
+/**
+ * @brief Internal FNV-1a hash function of node name.
+ * @param name node name
+ * @param length node name length
+ * @return uint64_t hash of the name
+ */
+uint64_t name_hash(const char *name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Internal function finds slot of node name in name index with linear probing.
+ * @param name node name, does not have to be null terminated
+ * @param length node name length
+ * @param hash hash of the node name
+ * @return size_t slot with node of that name or empty slot where the name belongs
+ */
+size_t name_index_find_slot(const char *name, size_t length, uint64_t hash)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    size_t mask = graph->name_index_capacity - 1;
+    size_t slot = (size_t)hash & mask;
+    uint32_t hash_tag = (uint32_t)(hash >> 32);
+    while (graph->name_index[slot].node != 0)
+    {
+        STATS_ADD(nameComparisonsCounter, 1);
+        if (graph->name_index[slot].hash == hash_tag)
+        {
+            uint64_t slot_name = graph->name_index[slot].name;
+            uint64_t slot_length = slot_name & NAME_SLOT_LENGTH_MASK;
+            if (slot_length == NAME_SLOT_LENGTH_MASK)
+            {
+                const uint64_t *offsets = &graph->name_offsets[graph->name_index[slot].node - 1];
+                slot_length = offsets[1] - offsets[0] - 1;
+            }
+            if (slot_length == length && memcmp(&graph->names[slot_name >> NAME_SLOT_LENGTH_BITS], name, length) == 0)
+            {
+                break;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Internal function stores node to name index slot, name of the node must be in name pool.
+ * @param slot name index slot
+ * @param nodeIndex node index
+ * @param hash hash of the node name
+ */
+void name_index_set_slot(size_t slot, unsigned int nodeIndex, uint64_t hash)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    uint64_t offset = graph->name_offsets[nodeIndex];
+    uint64_t length = graph->name_offsets[nodeIndex + 1] - offset - 1;
+    graph->name_index[slot].node = nodeIndex + 1;
+    graph->name_index[slot].hash = (uint32_t)(hash >> 32);
+    graph->name_index[slot].name = offset << NAME_SLOT_LENGTH_BITS | (length < NAME_SLOT_LENGTH_MASK ? length : NAME_SLOT_LENGTH_MASK);
+}
+
+/**
+ * @brief Internal function doubles name index capacity and reinserts all nodes.
+ * Index is kept at most half full, so probe sequences stay short.
+ */
+void name_index_grow()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    arena_free(&graph->arena, graph->name_index, graph->name_index_capacity, sizeof(name_slot_t));
+    graph->name_index_capacity = graph->name_index_capacity ? graph->name_index_capacity * 2 : 64;
+    graph->name_index = (name_slot_t *)arena_alloc(&graph->arena, graph->name_index_capacity, sizeof(name_slot_t));
+    for (unsigned int i = 0; i < graph->node_count; i++)
+    {
+        const char *name = &graph->names[graph->name_offsets[i]];
+        size_t length = (size_t)(graph->name_offsets[i + 1] - graph->name_offsets[i] - 1);
+        uint64_t hash = name_hash(name, length);
+        name_index_set_slot(name_index_find_slot(name, length, hash), i, hash);
+    }
 }
 
 /**
@@ -48,113 +293,696 @@ void *alloc(size_t n, size_t size)
  */
 void graph_init()
 {
-    if (graph)
+    graph_ctx_t *ctx = graph_ctx_current();
+    if (ctx->graph)
     {
         error_exit(internalError, "Graph was already initialized\n");
     }
-    graph = (graph_t *)alloc(1, sizeof(graph_t));
+    arena_t arena;
+    arena_init(&arena);
+    graph_t *graph = (graph_t *)arena_alloc(&arena, 1, sizeof(graph_t));
+    graph->arena = arena;
     graph->node_count = 0;
+    ctx->graph = graph;
 }
 
 /**
- * @brief Function destroys the graph.
+ * @brief Function creates a new graph in streaming mode. Edges are not stored,
+ * they only merge connected components of their nodes and increase node degrees.
+ */
+void graph_init_streaming()
+{
+    graph_init();
+    graph_t *graph = graph_ctx_current()->graph;
+    graph->streaming = true;
+    disjoint_set_init(&graph->components);
+}
+
+/**
+ * @brief Internal function checks that binary graph section of count items lies inside data.
+ * @param position section position
+ * @param count count of section items
+ * @param size size of each item
+ * @param length data length
+ * @return bool section is aligned and inside data
+ */
+bool binary_section_fits(uint64_t position, uint64_t count, size_t size, size_t length)
+{
+    return position % sizeof(uint64_t) == 0 && position <= length && count <= (length - position) / size;
+}
+
+/**
+ * @brief Internal function validates CSR arrays and names of loaded binary graph, so corrupted file can not make
+ * graph algorithms read out of bounds. Offsets must not decrease, neighbor lists must be strictly increasing
+ * without the vertex itself and every edge must be listed by both vertices, names must be null terminated.
+ * Edge (u,v) with v < u is matched to the next unmatched greater neighbor of v, lists are sorted,
+ * so all edges are matched in one pass.
+ *
+ * Time complexity: O(|V|+|E|)
+ * @throw Error when arrays are not valid.
+ * @param graph graph structure pointer
+ */
+void binary_validate(graph_t *graph)
+{
+    uint32_t node_count = graph->node_count;
+    const uint64_t *offsets = graph->edge_offsets;
+    const uint32_t *nodes = graph->edge_nodes;
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        if (graph->name_offsets[i] >= graph->name_offsets[i + 1] || graph->names[graph->name_offsets[i + 1] - 1] != '\0')
+        {
+            error_exit(parserBinaryFormatError, "Binary graph names are not valid\n");
+        }
+        if (offsets[i] > offsets[i + 1])
+        {
+            error_exit(parserBinaryFormatError, "Binary graph edge offsets are not valid\n");
+        }
+    }
+
+    // position of the next greater neighbor of every vertex, which is not matched to its reverse arc yet
+    uint64_t *unmatched = (uint64_t *)alloc(node_count, sizeof(uint64_t));
+    bool valid = true;
+    for (uint32_t u = 0; u < node_count && valid; u++)
+    {
+        uint64_t arc = offsets[u];
+        for (; arc < offsets[u + 1] && valid; arc++)
+        {
+            uint32_t v = nodes[arc];
+            valid = v < node_count && (arc == offsets[u] || nodes[arc - 1] < v) && v != u;
+            if (!valid || v > u)
+            {
+                break;
+            }
+            valid = unmatched[v] < offsets[v + 1] && nodes[unmatched[v]] == u;
+            unmatched[v]++;
+        }
+        unmatched[u] = arc;
+    }
+    for (uint32_t v = 0; v < node_count && valid; v++)
+    {
+        valid = unmatched[v] == offsets[v + 1];
+    }
+    alloc_free(unmatched);
+    if (!valid)
+    {
+        error_exit(parserBinaryFormatError, "Binary graph adjacency is not valid\n");
+    }
+}
+
+/**
+ * @brief Function loads binary graph to empty graph without parsing, CSR arrays and names point directly into data.
+ * Header, section bounds and content of CSR arrays and names are validated in one pass over the arrays.
+ * Graph takes ownership of storage and releases it when it is destroyed.
+ * @throw Error when data are not a valid binary graph of supported version.
+ * @param data binary graph data, 8 byte aligned, must stay unmodified until the graph is destroyed
+ * @param length data length
+ * @param storage memory containing data, released with graph
+ * @param storageLength storage length
+ * @param storageMapped storage is memory mapping (released by munmap) or allocated memory (released by free)
+ */
+void graph_load_binary(const char *data, size_t length, void *storage, size_t storageLength, bool storageMapped)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->node_count != 0 || graph->storage || graph->streaming)
+    {
+        error_exit(internalError, "Binary graph can be loaded only to empty graph\n");
+    }
+    graph->storage = storage;
+    graph->storage_length = storageLength;
+    graph->storage_mapped = storageMapped;
+
+    const graph_binary_header_t *header = (const graph_binary_header_t *)data;
+    if (length < sizeof(graph_binary_header_t) || memcmp(header->magic, GRAPH_BINARY_MAGIC, GRAPH_BINARY_MAGIC_LENGTH) != 0)
+    {
+        error_exit(parserBinaryFormatError, "Binary graph header is not valid\n");
+    }
+    if (header->version != GRAPH_BINARY_VERSION)
+    {
+        error_exit(parserBinaryFormatError, "Binary graph version %u is not supported (expected %u)\n", header->version, GRAPH_BINARY_VERSION);
+    }
+    if (header->node_count == 0 || header->node_count > MAX_NODE_COUNT || header->arc_count != header->edge_count * 2 ||
+        header->names_length < header->node_count ||
+        !binary_section_fits(header->edge_offsets_position, (uint64_t)header->node_count + 1, sizeof(uint64_t), length) ||
+        !binary_section_fits(header->edge_nodes_position, header->arc_count, sizeof(uint32_t), length) ||
+        !binary_section_fits(header->name_offsets_position, (uint64_t)header->node_count + 1, sizeof(uint64_t), length) ||
+        !binary_section_fits(header->names_position, header->names_length, sizeof(char), length))
+    {
+        error_exit(parserBinaryFormatError, "Binary graph sections are not valid\n");
+    }
+
+    // arrays are never written after finalization, so they can point into read-only mapping
+    graph->edge_offsets = (uint64_t *)(data + header->edge_offsets_position);
+    graph->edge_nodes = (uint32_t *)(data + header->edge_nodes_position);
+    graph->name_offsets = (uint64_t *)(data + header->name_offsets_position);
+    graph->names = (char *)(data + header->names_position);
+    if (graph->edge_offsets[0] != 0 || graph->edge_offsets[header->node_count] != header->arc_count ||
+        graph->name_offsets[header->node_count] != header->names_length || graph->names[header->names_length - 1] != '\0')
+    {
+        error_exit(parserBinaryFormatError, "Binary graph sections are not valid\n");
+    }
+
+    graph->node_count = header->node_count;
+    graph->edge_count = header->edge_count;
+    binary_validate(graph);
+    graph->finalized = true;
+}
+
+/**
+ * @brief Internal function writes data to binary graph stream.
+ * @throw Error when data can not be written.
+ * @param data data to write, NULL writes zero padding
+ * @param length data length
+ * @param stream output stream
+ */
+void binary_write(const void *data, size_t length, FILE *stream)
+{
+    static const char padding[sizeof(uint64_t)] = {0};
+    if (length != 0 && fwrite(data ? data : padding, 1, length, stream) != length)
+    {
+        error_exit(fileAccessError, "Binary graph can not be written\n");
+    }
+}
+
+/**
+ * @brief Internal function writes decimal names of all nodes of numbered graph to one name table,
+ * it is built when the first name is requested, so graphs which are only analyzed never store names.
+ */
+void numbered_names_build()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    graph->name_offsets = (uint64_t *)arena_alloc(&graph->arena, (size_t)graph->node_count + 1, sizeof(uint64_t));
+    for (unsigned int i = 0; i < graph->node_count; i++)
+    {
+        char buffer[NUMBER_NAME_SIZE];
+        graph->name_offsets[i + 1] = graph->name_offsets[i] + (uint64_t)snprintf(buffer, NUMBER_NAME_SIZE, "%u", i + graph->first_number) + 1;
+    }
+    graph->names = (char *)arena_alloc(&graph->arena, (size_t)graph->name_offsets[graph->node_count], sizeof(char));
+    for (unsigned int i = 0; i < graph->node_count; i++)
+    {
+        uint64_t offset = graph->name_offsets[i];
+        snprintf(&graph->names[offset], (size_t)(graph->name_offsets[i + 1] - offset), "%u", i + graph->first_number);
+    }
+}
+
+/**
+ * @brief Function writes finalized graph to stream in binary graph format, which can be loaded by graph_load_binary.
+ * @throw Error when graph is not finalized or data can not be written.
+ * @param stream output stream
+ */
+void graph_write_binary(FILE *stream)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (!graph->finalized || graph->streaming)
+    {
+        error_exit(internalError, "Only finalized graph can be written\n");
+    }
+
+    // numbered graph gets string pool in the same layout as named graph
+    static const uint64_t empty_name_offsets[1] = {0};
+    if (graph->numbered && !graph->names)
+    {
+        numbered_names_build();
+    }
+    const uint64_t *name_offsets = graph->node_count ? graph->name_offsets : empty_name_offsets;
+
+    graph_binary_header_t header = {
+        .version = GRAPH_BINARY_VERSION,
+        .node_count = graph->node_count,
+        .edge_count = graph->edge_count,
+        .arc_count = graph_get_arc_count(),
+        .names_length = name_offsets[graph->node_count],
+        .edge_offsets_position = sizeof(graph_binary_header_t),
+    };
+    memcpy(header.magic, GRAPH_BINARY_MAGIC, GRAPH_BINARY_MAGIC_LENGTH);
+    header.edge_nodes_position = header.edge_offsets_position + ((uint64_t)graph->node_count + 1) * sizeof(uint64_t);
+    uint64_t edge_nodes_length = header.arc_count * sizeof(uint32_t);
+    size_t edge_nodes_padding = (size_t)(-edge_nodes_length % sizeof(uint64_t));
+    header.name_offsets_position = header.edge_nodes_position + edge_nodes_length + edge_nodes_padding;
+    header.names_position = header.name_offsets_position + ((uint64_t)graph->node_count + 1) * sizeof(uint64_t);
+
+    binary_write(&header, sizeof(header), stream);
+    binary_write(graph->edge_offsets, ((size_t)graph->node_count + 1) * sizeof(uint64_t), stream);
+    binary_write(graph->edge_nodes, (size_t)edge_nodes_length, stream);
+    binary_write(NULL, edge_nodes_padding, stream);
+    binary_write(name_offsets, ((size_t)graph->node_count + 1) * sizeof(uint64_t), stream);
+    binary_write(graph->names, (size_t)name_offsets[graph->node_count], stream);
+}
+
+/**
+ * @brief Function destroys the graph, all graph memory is released at once with its arena.
  */
 void graph_destroy()
 {
+    graph_ctx_t *ctx = graph_ctx_current();
+    graph_t *graph = ctx->graph;
     if (!graph)
     {
         return;
     }
-    for (unsigned int i = 0; i < graph->node_count; i++)
+    if (graph->storage)
     {
-        free(graph->nodes[i]->name);
-        free(graph->nodes[i]);
+        if (graph->storage_mapped)
+        {
+            munmap(graph->storage, graph->storage_length);
+        }
+        else
+        {
+            alloc_free(graph->storage);
+        }
     }
-    free(graph);
+    disjoint_set_destroy(&graph->components);
+    arena_t arena = graph->arena;
+    ctx->graph = NULL;
+    arena_release(&arena);
+}
+
+/**
+ * @brief Internal function grows node arrays, so they have space for nodeCount nodes.
+ * Name offsets are only stored for named nodes, names of numbered nodes are built when requested.
+ * @param nodeCount required node count
+ */
+void node_arrays_reserve(uint64_t nodeCount)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (nodeCount <= graph->node_capacity)
+    {
+        return;
+    }
+    uint64_t capacity = graph->node_capacity ? graph->node_capacity : 16;
+    while (capacity < nodeCount)
+    {
+        capacity *= 2;
+    }
+    capacity = capacity < MAX_NODE_COUNT ? capacity : MAX_NODE_COUNT;
+    graph->degrees = (uint32_t *)arena_resize(&graph->arena, graph->degrees, graph->node_capacity, (size_t)capacity, sizeof(uint32_t));
+    memset(&graph->degrees[graph->node_capacity], 0, (size_t)(capacity - graph->node_capacity) * sizeof(uint32_t));
+    if (!graph->numbered)
+    {
+        graph->name_offsets = (uint64_t *)arena_resize(&graph->arena, graph->name_offsets, (size_t)graph->node_capacity + 1, (size_t)capacity + 1, sizeof(uint64_t));
+    }
+    graph->node_capacity = (unsigned int)capacity;
 }
 
 /**
  * @brief Function creates a new node in graph.
  * @throw Error when graph is full (max nodes created) or node with same name already exist.
- * @param nodeName name of the node
+ * @param nodeName name of the node, does not have to be null terminated
+ * @param nodeNameLength length of the node name
  */
-void graph_create_node(char *nodeName)
+void graph_create_node(const char *nodeName, size_t nodeNameLength)
 {
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->finalized || graph->numbered)
+    {
+        error_exit(internalError, "Named node can not be added to %s graph\n", graph->finalized ? "finalized" : "numbered");
+    }
     if (graph->node_count >= MAX_NODE_COUNT)
     {
-        error_exit(parserNodeCountOverflowError, "Node limit reached (%i)\n", MAX_NODE_COUNT);
+        error_exit(parserNodeCountOverflowError, "Node limit reached (%u)\n", MAX_NODE_COUNT);
     }
-    for (unsigned int i = 0; i < graph->node_count; i++)
+    if (((size_t)graph->node_count + 1) * 2 > graph->name_index_capacity)
+    {
+        name_index_grow();
+    }
+    uint64_t hash = name_hash(nodeName, nodeNameLength);
+    size_t slot = name_index_find_slot(nodeName, nodeNameLength, hash);
+    if (graph->name_index[slot].node != 0)
     {
-        if (strcmp(graph->nodes[i]->name, nodeName) == 0)
+        error_exit(graphNodeNameDuplicationError, "Node with name '%.*s' already exists\n", (int)nodeNameLength, nodeName);
+    }
+
+    node_arrays_reserve((uint64_t)graph->node_count + 1);
+    uint64_t name_offset = graph->name_offsets[graph->node_count];
+    if (name_offset + nodeNameLength + 1 > graph->names_capacity)
+    {
+        uint64_t capacity = graph->names_capacity ? graph->names_capacity * 2 : 256;
+        while (capacity < name_offset + nodeNameLength + 1)
         {
-            error_exit(graphNodeNameDuplicationError, "Node with name '%s' already exists\n", nodeName);
+            capacity *= 2;
         }
+        graph->names = (char *)arena_resize(&graph->arena, graph->names, (size_t)graph->names_capacity, (size_t)capacity, sizeof(char));
+        graph->names_capacity = capacity;
     }
+    memcpy(&graph->names[name_offset], nodeName, nodeNameLength);
+    graph->names[name_offset + nodeNameLength] = '\0';
+    graph->name_offsets[graph->node_count + 1] = name_offset + nodeNameLength + 1;
+    name_index_set_slot(slot, graph->node_count++, hash);
 
-    node_t *node = (node_t *)alloc(1, sizeof(node_t));
-    node->name = (char *)alloc(strlen(nodeName) + 1, sizeof(char));
-    strcpy(node->name, nodeName);
-    node->edge_count = 0;
-    graph->nodes[graph->node_count++] = node;
+    if (graph->streaming)
+    {
+        disjoint_set_add(&graph->components);
+    }
 }
 
 /**
- * @brief Function returns node structure by its name.
- * @param nodeName name of the node
- * @return node_t* node structure pointer
+ * @brief Function creates nodes of numbered graph until it has nodeCount nodes, nodes are named
+ * by their index + firstNumber, so edges are created by index without name hashing.
+ * @throw Error when node limit is exceeded or graph has named nodes.
+ * @param nodeCount required node count
+ * @param firstNumber number of the node with index 0, must be the same for all calls
  */
-node_t *graph_get_node_by_name(char *nodeName)
+void graph_create_numbered_nodes(uint64_t nodeCount, unsigned int firstNumber)
 {
-    for (unsigned int i = 0; i < graph->node_count; i++)
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->finalized || (graph->node_count != 0 && !graph->numbered) || (graph->numbered && graph->first_number != firstNumber))
+    {
+        error_exit(internalError, "Numbered nodes can not be added to graph\n");
+    }
+    if (nodeCount > MAX_NODE_COUNT)
     {
-        if (strcmp(graph->nodes[i]->name, nodeName) == 0)
+        error_exit(parserNodeCountOverflowError, "Node limit reached (%u)\n", MAX_NODE_COUNT);
+    }
+    graph->numbered = true;
+    graph->first_number = firstNumber;
+    if (nodeCount <= graph->node_count)
+    {
+        return;
+    }
+
+    node_arrays_reserve(nodeCount);
+    if (graph->streaming)
+    {
+        for (uint64_t i = graph->node_count; i < nodeCount; i++)
         {
-            return graph->nodes[i];
+            disjoint_set_add(&graph->components);
         }
     }
-    error_exit(graphNodeNotFoundError, "Node with name '%s' not found\n", nodeName);
-    return NULL;
+    graph->node_count = (unsigned int)nodeCount;
 }
 
 /**
- * @brief Function returns node structure by its index.
- * @param nodeIndex name of the node
- * @return node_t* node structure pointer
+ * @brief Internal function returns name of node, name of numbered node is written to buffer.
+ * @param nodeIndex node index
+ * @param buffer buffer for name of numbered node
+ * @return const char* node name
  */
-node_t *graph_get_node_by_index(unsigned int nodeIndex)
+const char *node_get_name(unsigned int nodeIndex, char buffer[NUMBER_NAME_SIZE])
 {
-    if (nodeIndex >= graph->node_count)
+    graph_t *graph = graph_ctx_current()->graph;
+    if (!graph->numbered)
+    {
+        return &graph->names[graph->name_offsets[nodeIndex]];
+    }
+    snprintf(buffer, NUMBER_NAME_SIZE, "%u", nodeIndex + graph->first_number);
+    return buffer;
+}
+
+/**
+ * @brief Internal function returns node index by its name, using name hash index (O(1) expected).
+ * @throw Error when node with that name does not exist.
+ * @param nodeName name of the node, does not have to be null terminated
+ * @param nodeNameLength length of the node name
+ * @return uint32_t node index
+ */
+uint32_t node_find_by_name(const char *nodeName, size_t nodeNameLength)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->name_index_capacity != 0)
+    {
+        uint64_t hash = name_hash(nodeName, nodeNameLength);
+        uint32_t slot_node = graph->name_index[name_index_find_slot(nodeName, nodeNameLength, hash)].node;
+        if (slot_node != 0)
+        {
+            return slot_node - 1;
+        }
+    }
+    error_exit(graphNodeNotFoundError, "Node with name '%.*s' not found\n", (int)nodeNameLength, nodeName);
+    return 0;
+}
+
+/**
+ * @brief Function creates a new edge between 2 nodes in graph given by their indexes.
+ * Edge is only buffered, duplicate edges are removed and reported together by graph_finalize.
+ * @throw Error when nodes are equal or out of range.
+ * @param nodeIndex index of the first node
+ * @param node2Index index of the second node
+ */
+void graph_create_edge_by_index(uint32_t nodeIndex, uint32_t node2Index)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->finalized)
+    {
+        error_exit(internalError, "Graph was already finalized\n");
+    }
+    if (nodeIndex >= graph->node_count || node2Index >= graph->node_count)
     {
         error_exit(graphNodeNotFoundError, "Node index out of range\n");
     }
+    char name_buffer[NUMBER_NAME_SIZE];
+    if (nodeIndex == node2Index)
+    {
+        error_exit(graphNodeEdgeLoopError, "Node '%s' cannot have an edge to itself\n", node_get_name(nodeIndex, name_buffer));
+    }
+    graph->edge_count++;
 
-    return graph->nodes[nodeIndex];
+    if (graph->streaming)
+    {
+        // edge inside one component closes a cycle, duplicate edges can not be detected without adjacency
+        if (!disjoint_set_union(&graph->components, nodeIndex, node2Index))
+        {
+            graph->streamed_cycle = true;
+        }
+        graph->degrees[nodeIndex]++;
+        graph->degrees[node2Index]++;
+        return;
+    }
+
+    if (graph->edge_pair_count == graph->edge_pair_capacity)
+    {
+        uint64_t capacity = graph->edge_pair_capacity ? graph->edge_pair_capacity * 2 : 64;
+        graph->edge_pairs = (uint64_t *)arena_resize(&graph->arena, graph->edge_pairs, (size_t)graph->edge_pair_capacity, (size_t)capacity, sizeof(uint64_t));
+        graph->edge_pair_capacity = capacity;
+    }
+    if (graph->mirrored_edges)
+    {
+        graph->edge_pairs[graph->edge_pair_count++] = (uint64_t)nodeIndex << 32 | node2Index;
+        return;
+    }
+    uint32_t smaller = nodeIndex < node2Index ? nodeIndex : node2Index;
+    uint32_t larger = nodeIndex < node2Index ? node2Index : nodeIndex;
+    graph->edge_pairs[graph->edge_pair_count++] = (uint64_t)smaller << 32 | larger;
+}
+
+/**
+ * @brief Function sets that edges of graph may be given in both directions, as in adjacency matrix
+ * of unoriented graph, so edge (b,a) after edge (a,b) is not reported as duplicate. Repeated (a,b)
+ * is still reported, except in graph of more than 2^31 nodes where direction is not stored.
+ * Must be called before any edge is created.
+ */
+void graph_set_mirrored_edges()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->finalized || graph->edge_pair_count != 0)
+    {
+        error_exit(internalError, "Edges were already created\n");
+    }
+    graph->mirrored_edges = true;
 }
 
 /**
  * @brief Function creates a new edge between 2 nodes in graph.
- * @param nodeName name of the first node
- * @param node2Name name of the second node
+ * @param nodeName name of the first node, does not have to be null terminated
+ * @param nodeNameLength length of the first node name
+ * @param node2Name name of the second node, does not have to be null terminated
+ * @param node2NameLength length of the second node name
+ */
+void graph_create_edge(const char *nodeName, size_t nodeNameLength, const char *node2Name, size_t node2NameLength)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->finalized)
+    {
+        error_exit(internalError, "Graph was already finalized\n");
+    }
+    if (nodeNameLength == node2NameLength && memcmp(nodeName, node2Name, nodeNameLength) == 0)
+    {
+        error_exit(graphNodeEdgeLoopError, "Node '%.*s' cannot have an edge to itself\n", (int)nodeNameLength, nodeName);
+    }
+    // the first missing node is reported
+    uint32_t node_index = node_find_by_name(nodeName, nodeNameLength);
+    uint32_t node2_index = node_find_by_name(node2Name, node2NameLength);
+    graph_create_edge_by_index(node_index, node2_index);
+}
+
+/**
+ * @brief Internal function sorts keys by least significant digit radix sort.
+ * @param keys keys to sort
+ * @param buffer buffer of the same size as keys
+ * @param count count of keys
+ * @param keyBits count of low bits used by keys, higher bits must be zero
+ * @return uint64_t* sorted keys, either keys or buffer
+ */
+uint64_t *radix_sort(uint64_t *keys, uint64_t *buffer, uint64_t count, unsigned int keyBits)
+{
+    uint64_t *bucket_offsets = (uint64_t *)alloc((size_t)1 << RADIX_BITS, sizeof(uint64_t));
+    for (unsigned int shift = 0; shift < keyBits; shift += RADIX_BITS)
+    {
+        uint64_t digit_mask = ((uint64_t)1 << RADIX_BITS) - 1;
+        memset(bucket_offsets, 0, sizeof(uint64_t) << RADIX_BITS);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            bucket_offsets[(keys[i] >> shift) & digit_mask]++;
+        }
+        uint64_t offset = 0;
+        for (size_t digit = 0; digit <= digit_mask; digit++)
+        {
+            uint64_t bucket_size = bucket_offsets[digit];
+            bucket_offsets[digit] = offset;
+            offset += bucket_size;
+        }
+        for (uint64_t i = 0; i < count; i++)
+        {
+            buffer[bucket_offsets[(keys[i] >> shift) & digit_mask]++] = keys[i];
+        }
+        uint64_t *sorted = buffer;
+        buffer = keys;
+        keys = sorted;
+    }
+    alloc_free(bucket_offsets);
+    return keys;
+}
+
+/**
+ * @brief Internal function prints one warning with count of duplicate edges and their first examples.
+ * @param duplicateCount count of ignored duplicate edges
+ * @param examples first duplicate edges as (node index, node index) pairs
+ */
+void duplicate_edges_warning(uint64_t duplicateCount, const uint32_t examples[][2])
+{
+    char message[DUPLICATE_EDGE_EXAMPLE_COUNT * (2 * MAX_NODE_NAME_LENGTH + 8)] = "";
+    size_t length = 0;
+    uint64_t example_count = duplicateCount < DUPLICATE_EDGE_EXAMPLE_COUNT ? duplicateCount : DUPLICATE_EDGE_EXAMPLE_COUNT;
+    for (uint64_t i = 0; i < example_count && length < sizeof(message); i++)
+    {
+        char name_buffer[NUMBER_NAME_SIZE];
+        char name2_buffer[NUMBER_NAME_SIZE];
+        length += (size_t)snprintf(message + length, sizeof(message) - length, "%s(%s,%s)", i ? ", " : "",
+                                   node_get_name(examples[i][0], name_buffer), node_get_name(examples[i][1], name2_buffer));
+    }
+    warning_print("%" PRIu64 " duplicate edges were ignored: %s%s\n", duplicateCount, message, duplicateCount > example_count ? ", ..." : "");
+}
+
+/**
+ * @brief Function builds contiguous CSR arrays from buffered edges. Edges are radix sorted,
+ * so duplicates are adjacent and removed in one pass, and neighbors of every node are sorted by index.
+ * Graph can not be modified after finalization. Streaming graph has no adjacency to build.
+ *
+ * Time complexity: O(|V|+|E|)
  */
-void graph_create_edge(char *nodeName, char *node2Name)
+void graph_finalize()
 {
-    if (strcmp(nodeName, node2Name) == 0)
+    graph_ctx_t *ctx = graph_ctx_current();
+    graph_t *graph = ctx->graph;
+    // memory allocated so far was used by parsing, the rest by building
+    memory_usage_collect(&ctx->parse_memory);
+    if (graph->finalized || graph->streaming)
+    {
+        graph->finalized = true;
+        return;
+    }
+
+    // pack pairs to as few bits as node indexes need, so radix sort makes less passes
+    unsigned int index_bits = 1;
+    while (index_bits < 32 && ((uint64_t)1 << index_bits) < graph->node_count)
+    {
+        index_bits++;
+    }
+    uint64_t index_mask = ((uint64_t)1 << index_bits) - 1;
+    uint64_t pair_count = graph->edge_pair_count;
+    uint64_t *pairs = graph->edge_pairs;
+    // direction of mirrored edge is kept in the lowest bit while there is a spare bit,
+    // so (b,a) after (a,b) is told apart from repeated (a,b)
+    unsigned int direction_bits = graph->mirrored_edges && index_bits < 32 ? 1 : 0;
+    for (uint64_t i = 0; i < pair_count; i++)
+    {
+        uint64_t first = pairs[i] >> 32, second = pairs[i] & UINT32_MAX;
+        if (graph->mirrored_edges)
+        {
+            pairs[i] = ((first < second ? first : second) << index_bits | (first < second ? second : first)) << direction_bits | (uint64_t)(first > second && direction_bits);
+        }
+        else
+        {
+            pairs[i] = first << index_bits | second;
+        }
+    }
+    uint64_t *buffer = (uint64_t *)arena_alloc(&graph->arena, (size_t)pair_count, sizeof(uint64_t));
+    pairs = radix_sort(pairs, buffer, pair_count, 2 * index_bits + direction_bits);
+    if (pairs == buffer)
     {
-        error_exit(graphNodeEdgeLoopError, "Node '%s' cannot have an edge to itself\n", nodeName);
+        arena_free(&graph->arena, graph->edge_pairs, (size_t)graph->edge_pair_capacity, sizeof(uint64_t));
+        graph->edge_pairs = pairs;
+        graph->edge_pair_capacity = pair_count;
     }
-    node_t *node = graph_get_node_by_name(nodeName);
-    node_t *node2 = graph_get_node_by_name(node2Name);
-    for (unsigned int i = 0; i < node->edge_count; i++)
+    else
     {
-        if (node->edge_nodes[i] == node2)
+        arena_free(&graph->arena, buffer, (size_t)pair_count, sizeof(uint64_t));
+    }
+
+    uint64_t unique_count = 0;
+    uint64_t duplicate_count = 0;
+    uint32_t duplicate_examples[DUPLICATE_EDGE_EXAMPLE_COUNT][2];
+    // direction of the previous pair, the first reversed pair of an edge is its mirror, not a duplicate
+    uint64_t previous_direction = 0;
+    for (uint64_t i = 0; i < pair_count; i++)
+    {
+        uint64_t direction = pairs[i] & direction_bits;
+        uint64_t pair = pairs[i] >> direction_bits;
+        if (unique_count != 0 && pairs[unique_count - 1] == pair)
         {
-            warning_print("Edge (%s,%s) already exists, edges (%s,%s) and (%s,%s) are equal\n", nodeName, node2Name, nodeName, node2Name, node2Name, nodeName);
-            return;
+            bool mirror = direction && !previous_direction;
+            previous_direction = direction;
+            if (mirror)
+            {
+                continue;
+            }
+            if (duplicate_count < DUPLICATE_EDGE_EXAMPLE_COUNT)
+            {
+                duplicate_examples[duplicate_count][0] = (uint32_t)(pair >> index_bits);
+                duplicate_examples[duplicate_count][1] = (uint32_t)(pair & index_mask);
+            }
+            duplicate_count++;
+            continue;
         }
+        previous_direction = direction;
+        pairs[unique_count++] = pair;
+        graph->degrees[pair >> index_bits]++;
+        graph->degrees[pair & index_mask]++;
     }
-    node->edge_nodes[node->edge_count++] = node2;
-    node2->edge_nodes[node2->edge_count++] = node;
+    if (duplicate_count)
+    {
+        duplicate_edges_warning(duplicate_count, (const uint32_t(*)[2])duplicate_examples);
+    }
+    graph->edge_count = unique_count;
+
+    graph->edge_offsets = (uint64_t *)arena_alloc(&graph->arena, (size_t)graph->node_count + 1, sizeof(uint64_t));
+    for (unsigned int i = 0; i < graph->node_count; i++)
+    {
+        graph->edge_offsets[i + 1] = graph->edge_offsets[i] + graph->degrees[i];
+    }
+
+    // allocate at least one item, so empty edge list is not NULL
+    uint64_t adjacency_size = graph->edge_offsets[graph->node_count];
+    graph->edge_nodes = (uint32_t *)arena_alloc(&graph->arena, adjacency_size ? adjacency_size : 1, sizeof(uint32_t));
+    // smaller neighbors of a node are all reached before its own pairs, so every list ends up sorted
+    uint64_t *fill_offsets = (uint64_t *)alloc((size_t)graph->node_count + 1, sizeof(uint64_t));
+    memcpy(fill_offsets, graph->edge_offsets, ((size_t)graph->node_count + 1) * sizeof(uint64_t));
+    for (uint64_t i = 0; i < unique_count; i++)
+    {
+        uint32_t smaller = (uint32_t)(pairs[i] >> index_bits);
+        uint32_t larger = (uint32_t)(pairs[i] & index_mask);
+        graph->edge_nodes[fill_offsets[smaller]++] = larger;
+        graph->edge_nodes[fill_offsets[larger]++] = smaller;
+    }
+    alloc_free(fill_offsets);
+    // degrees are read from CSR offsets from now on
+    arena_free(&graph->arena, graph->edge_pairs, (size_t)graph->edge_pair_capacity, sizeof(uint64_t));
+    arena_free(&graph->arena, graph->degrees, graph->node_capacity, sizeof(uint32_t));
+    graph->edge_pairs = NULL;
+    graph->edge_pair_count = 0;
+    graph->edge_pair_capacity = 0;
+    graph->degrees = NULL;
+
+    graph->finalized = true;
+    memory_usage_collect(&ctx->build_memory);
 }
 
 /**
@@ -163,45 +991,177 @@ void graph_create_edge(char *nodeName, char *node2Name)
  */
 unsigned int graph_get_node_count()
 {
+    graph_t *graph = graph_ctx_current()->graph;
     return graph->node_count;
 }
 
 /**
- * @brief Function returns node structure of the edge connected node by index
- * @param node node structure pointer
- * @param edgeNodeIndex index of the edge node
- * @return node_t* node structure pointer
+ * @brief Functions returns count of all edges in graph, edges are counted while they are created
+ * and duplicates are removed by graph_finalize, in streaming mode duplicate edges are included
+ * @return uint64_t edge count
  */
-node_t *node_get_edge_node_by_index(node_t *node, unsigned int edgeNodeIndex)
+uint64_t graph_get_edge_count()
 {
-    return node->edge_nodes[edgeNodeIndex];
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->edge_count;
 }
 
 /**
- * @brief Function returns count of all edges connected to node
- * @param node node structure pointer
- * @return int node count
+ * @brief Function returns count of all arcs in graph, every edge is stored as 2 arcs (one in each direction)
+ * @return uint64_t arc count
  */
-unsigned int node_get_edge_count(node_t *node)
+uint64_t graph_get_arc_count()
 {
-    return node->edge_count;
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->edge_offsets[graph->node_count];
 }
 
 /**
- * @brief Get node index in graph
- * @param node node to be searched
- * @return index of node in graph->nodes array
+ * @brief Function returns index of the first arc of vertex, arcs of vertex are numbered
+ * contiguously in the order of graph_get_vertex_neighbors
+ * @param vertex vertex index
+ * @return uint64_t arc index
  */
-unsigned int graph_get_node_index(node_t *node)
+uint64_t graph_get_vertex_arc_offset(uint32_t vertex)
 {
-    unsigned int node_count = graph_get_node_count();
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->edge_offsets[vertex];
+}
 
-    for (unsigned int i = 0; i < node_count; i++)
+/**
+ * @brief Function returns count of all edges connected to vertex
+ * @param vertex vertex index
+ * @return uint32_t vertex degree
+ */
+uint32_t graph_get_vertex_degree(uint32_t vertex)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->streaming)
     {
-        if (graph_get_node_by_index(i) == node)
+        return graph->degrees[vertex];
+    }
+    return (uint32_t)(graph->edge_offsets[vertex + 1] - graph->edge_offsets[vertex]);
+}
+
+/**
+ * @brief Function returns indexes of all vertices connected to vertex,
+ * they are stored contiguously in graph CSR arrays.
+ * @param vertex vertex index
+ * @return vertex_span_t neighbor indexes
+ */
+vertex_span_t graph_get_vertex_neighbors(uint32_t vertex)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    vertex_span_t span = {
+        .ids = &graph->edge_nodes[graph->edge_offsets[vertex]],
+        .count = graph_get_vertex_degree(vertex),
+    };
+    return span;
+}
+
+/**
+ * @brief Function returns name of the vertex
+ * @param vertex vertex index
+ * @return const char* vertex name
+ */
+const char *graph_get_vertex_name(uint32_t vertex)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->numbered && !graph->names)
+    {
+        numbered_names_build();
+    }
+    return &graph->names[graph->name_offsets[vertex]];
+}
+
+/**
+ * @brief Function returns if graph is in streaming mode, streaming graph has no adjacency
+ * and only node and streaming accessors can be used
+ * @return bool graph is in streaming mode
+ */
+bool graph_is_streaming()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->streaming;
+}
+
+/**
+ * @brief Function returns count of connected components of streaming graph
+ * @return uint32_t component count
+ */
+uint32_t graph_stream_get_component_count()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->components.set_count;
+}
+
+/**
+ * @brief Function returns if any streamed edge connected 2 nodes already in the same component
+ * @return bool graph has a cycle (or duplicate edge)
+ */
+bool graph_stream_has_cycle()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->streamed_cycle;
+}
+
+/**
+ * @brief Function returns if graph has adjacency matrix, it is built on the first call when finalized graph
+ * has at most GRAPH_MATRIX_MAX_NODE_COUNT nodes and at least GRAPH_MATRIX_MIN_DENSITY of all possible edges,
+ * so matrix takes at most |V|^2 / 8 bytes and its rows are not much larger than neighbor arrays.
+ * Matrix is not built when it does not fit in memory limit of context.
+ * Must not be called concurrently with other graph functions.
+ *
+ * Time complexity: O(|V|^2 / 64 + |E|) first time, O(1) afterwards
+ * @return bool graph has adjacency matrix
+ */
+bool graph_has_adjacency_matrix()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    if (graph->matrix)
+    {
+        return true;
+    }
+    uint64_t node_count = graph->node_count;
+    if (!graph->finalized || graph->streaming || node_count < 2 || node_count > GRAPH_MATRIX_MAX_NODE_COUNT ||
+        (double)graph->edge_count < GRAPH_MATRIX_MIN_DENSITY * (double)(node_count * (node_count - 1) / 2) ||
+        !memory_usage_fits(node_count * BITSET_WORD_COUNT(node_count) * sizeof(uint64_t)))
+    {
+        return false;
+    }
+
+    graph->matrix_row_words = BITSET_WORD_COUNT(node_count);
+    graph->matrix = (uint64_t *)arena_alloc(&graph->arena, node_count * graph->matrix_row_words, sizeof(uint64_t));
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        uint64_t *row = &graph->matrix[i * graph->matrix_row_words];
+        vertex_span_t neighbors = graph_get_vertex_neighbors(i);
+        for (uint32_t j = 0; j < neighbors.count; j++)
         {
-            return i;
+            row[neighbors.ids[j] / BITSET_WORD_BITS] |= (uint64_t)1 << (neighbors.ids[j] % BITSET_WORD_BITS);
         }
     }
-    return 0;
+    return true;
+}
+
+/**
+ * @brief Function returns count of 64-bit words of adjacency matrix row
+ * @return size_t row word count
+ */
+size_t graph_get_matrix_row_word_count()
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    return graph->matrix_row_words;
+}
+
+/**
+ * @brief Function returns adjacency matrix row of vertex, bit j is set when vertex is connected to vertex j,
+ * graph_has_adjacency_matrix must return true before
+ * @param vertex vertex index
+ * @return const uint64_t* row words
+ */
+const uint64_t *graph_get_vertex_row(uint32_t vertex)
+{
+    graph_t *graph = graph_ctx_current()->graph;
+    return &graph->matrix[vertex * graph->matrix_row_words];
 }
@@ -0,0 +1,403 @@
+/**
+ * @file graph_ctx.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for graph context and graph properties library interface,
+ * library calls bind their context to the calling thread and return error code instead of exiting
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <pthread.h>
+#include "../include/graph_ctx.h"
+#include "../include/graph.h"
+#include "../include/parser.h"
+#include "../include/graph_properties.h"
+#include "../include/thread_pool.h"
+#include "../include/stats.h"
+
+/**
+ * @brief Arguments of parse operation.
+ */
+typedef struct parse_arguments
+{
+    FILE *stream;
+    bool streaming;
+} parse_arguments_t;
+
+// context used by threads which did not bind any, so single graph programs need no context
+graph_ctx_t graph_ctx_default = {.thread_count = 1, .repeat_count = 1, .memory = {.lock = PTHREAD_MUTEX_INITIALIZER}};
+
+_Thread_local graph_ctx_t *graph_ctx_bound = NULL;
+
+// error_exit jumps here while library call runs on this thread
+_Thread_local jmp_buf *graph_ctx_error_jump = NULL;
+
+// workers of one context can fail at once, only the first error is kept
+pthread_mutex_t graph_ctx_error_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Function creates a new empty graph context.
+ * @return graph_ctx_t* context or NULL when allocation fails
+ */
+graph_ctx_t *graph_ctx_create()
+{
+    graph_ctx_t *ctx = (graph_ctx_t *)calloc(1, sizeof(graph_ctx_t));
+    if (ctx)
+    {
+        ctx->thread_count = 1;
+        ctx->repeat_count = 1;
+        pthread_mutex_init(&ctx->memory.lock, NULL);
+    }
+    return ctx;
+}
+
+/**
+ * @brief Function destroys graph context with its graph, parser state and computed properties.
+ * @param ctx context or NULL
+ */
+void graph_ctx_destroy(graph_ctx_t *ctx)
+{
+    if (!ctx)
+    {
+        return;
+    }
+    graph_ctx_t *previous = graph_ctx_bind(ctx);
+    graph_destroy();
+    parser_destroy();
+    graph_properties_destroy();
+    memory_scope_release(0);
+    graph_ctx_bind(previous);
+    pthread_mutex_destroy(&ctx->memory.lock);
+    free(ctx);
+}
+
+/**
+ * @brief Function returns context bound to calling thread.
+ * @return graph_ctx_t* bound context or default context
+ */
+graph_ctx_t *graph_ctx_current()
+{
+    return graph_ctx_bound ? graph_ctx_bound : &graph_ctx_default;
+}
+
+/**
+ * @brief Function binds context to calling thread, internal functions work with bound context.
+ * @param ctx context, NULL binds default context
+ * @return graph_ctx_t* previously bound context
+ */
+graph_ctx_t *graph_ctx_bind(graph_ctx_t *ctx)
+{
+    graph_ctx_t *previous = graph_ctx_bound;
+    graph_ctx_bound = ctx;
+    return previous;
+}
+
+/**
+ * @brief Function sets where error_exit jumps on calling thread, NULL makes errors exit the program.
+ * @param jump jump buffer or NULL
+ * @return jmp_buf* previous jump buffer
+ */
+jmp_buf *graph_ctx_set_error_jump(jmp_buf *jump)
+{
+    jmp_buf *previous = graph_ctx_error_jump;
+    graph_ctx_error_jump = jump;
+    return previous;
+}
+
+/**
+ * @brief Function stores error to bound context and returns from library call, called by error_exit.
+ * Returns only when no library call runs on calling thread. Error already stored by other thread
+ * working on the context is kept.
+ * @param errcode error code
+ * @param msg error message format
+ * @param args error message arguments
+ */
+void graph_ctx_fail(errorCodes_t errcode, const char *msg, va_list args)
+{
+    if (!graph_ctx_error_jump)
+    {
+        return;
+    }
+    graph_ctx_t *ctx = graph_ctx_current();
+    pthread_mutex_lock(&graph_ctx_error_lock);
+    if (ctx->error_code == noError)
+    {
+        ctx->error_code = errcode;
+        vsnprintf(ctx->error_message, GRAPH_CTX_ERROR_MESSAGE_SIZE, msg, args);
+    }
+    pthread_mutex_unlock(&graph_ctx_error_lock);
+    longjmp(*graph_ctx_error_jump, 1);
+}
+
+/**
+ * @brief Function runs operation with context bound to calling thread, errors of the operation are returned.
+ * Failed operation leaves context without graph and computed properties, memory it allocated is freed.
+ * @param ctx context
+ * @param operation operation
+ * @param argument operation argument
+ * @return errorCodes_t noError or error code of the operation, message is returned by graph_ctx_get_error
+ */
+errorCodes_t graph_ctx_run(graph_ctx_t *ctx, graph_ctx_operation_t operation, void *argument)
+{
+    graph_ctx_t *previous = graph_ctx_bind(ctx);
+    jmp_buf jump;
+    jmp_buf *previous_jump = graph_ctx_set_error_jump(&jump);
+    ctx->error_code = noError;
+    ctx->error_message[0] = '\0';
+    uint64_t scope = memory_scope_begin();
+
+    if (setjmp(jump) == 0)
+    {
+        operation(argument);
+    }
+    else
+    {
+        graph_ctx_set_error_jump(previous_jump);
+        parser_release();
+        graph_destroy();
+        graph_properties_reset();
+        memory_scope_release(scope);
+    }
+
+    graph_ctx_set_error_jump(previous_jump);
+    stats_flush();
+    graph_ctx_bind(previous);
+    return ctx->error_code;
+}
+
+/**
+ * @brief Function returns message of the last error of context.
+ * @param ctx context
+ * @return const char* error message, empty when the last call succeeded
+ */
+const char *graph_ctx_get_error(graph_ctx_t *ctx)
+{
+    return ctx->error_message;
+}
+
+/**
+ * @brief Set input format of context.
+ * @param ctx context
+ * @param name format name (auto, graph, gbin, edges, dimacs or mtx)
+ * @return bool format name is known
+ */
+bool graph_ctx_set_format(graph_ctx_t *ctx, const char *name)
+{
+    graph_ctx_t *previous = graph_ctx_bind(ctx);
+    bool known = parser_set_format(name);
+    graph_ctx_bind(previous);
+    return known;
+}
+
+/**
+ * @brief Set count of threads used for parallel property computation.
+ * @param ctx context
+ * @param count thread count, 0 for count of online processors
+ */
+void graph_ctx_set_thread_count(graph_ctx_t *ctx, unsigned int count)
+{
+    ctx->thread_count = count ? count : thread_pool_get_processor_count();
+}
+
+/**
+ * @brief Set maximal length of counted cycles.
+ * @param ctx context
+ * @param length maximal cycle length, 0 counts all cycles
+ */
+void graph_ctx_set_cycle_length_limit(graph_ctx_t *ctx, unsigned int length)
+{
+    ctx->cycle_length_limit = length;
+}
+
+/**
+ * @brief Set count of analysis runs, every run computes all properties from scratch
+ * and runtime of every property is printed as minimum, median and 99th percentile of all runs.
+ * @param ctx context
+ * @param count run count, 0 is one run
+ */
+void graph_ctx_set_repeat_count(graph_ctx_t *ctx, unsigned int count)
+{
+    ctx->repeat_count = count ? count : 1;
+}
+
+/**
+ * @brief Set if operation counters of every property are printed with analysis.
+ * @param ctx context
+ * @param enabled counters are printed
+ * @return bool counters are available (program was built with GRAPH_STATS)
+ */
+bool graph_ctx_set_stats(graph_ctx_t *ctx, bool enabled)
+{
+    ctx->stats_enabled = enabled;
+    return stats_available();
+}
+
+/**
+ * @brief Set memory limit of context, allocations above the limit fail and expensive properties
+ * which do not fit are reported as not computed.
+ * @param ctx context
+ * @param bytes limit of live tracked bytes, 0 is no limit
+ */
+void graph_ctx_set_memory_limit(graph_ctx_t *ctx, uint64_t bytes)
+{
+    ctx->memory.limit = bytes;
+}
+
+/**
+ * @brief Set if allocated memory of every phase and peak resident set size are printed with analysis.
+ * @param ctx context
+ * @param enabled memory is printed
+ */
+void graph_ctx_set_memory_report(graph_ctx_t *ctx, bool enabled)
+{
+    ctx->memory_enabled = enabled;
+}
+
+/**
+ * @brief Set stream where analysis is printed.
+ * @param ctx context
+ * @param output output stream, NULL is stdout
+ */
+void graph_ctx_set_output(graph_ctx_t *ctx, FILE *output)
+{
+    ctx->output = output;
+}
+
+/**
+ * @brief Set stream where warnings are printed.
+ * @param ctx context
+ * @param output output stream, NULL is stderr
+ */
+void graph_ctx_set_warning_output(graph_ctx_t *ctx, FILE *output)
+{
+    ctx->warning_output = output;
+}
+
+/**
+ * @brief Internal parse operation, previous graph of context is replaced.
+ * @param argument parse arguments
+ */
+void graph_ctx_parse_operation(void *argument)
+{
+    parse_arguments_t *arguments = (parse_arguments_t *)argument;
+    graph_ctx_t *ctx = graph_ctx_current();
+    graph_destroy();
+    graph_properties_reset();
+    memory_usage_collect(NULL);
+    ctx->parse_memory = (memory_phase_t){0};
+    ctx->build_memory = (memory_phase_t){0};
+    if (arguments->streaming)
+    {
+        parse_data_streaming(arguments->stream);
+    }
+    else
+    {
+        parse_data(arguments->stream);
+    }
+    memory_usage_collect(&ctx->parse_memory);
+}
+
+/**
+ * @brief Function reads graph of context from stream in selected input format.
+ * @param ctx context
+ * @param stream input stream
+ * @param streaming read graph in streaming mode (edges are not stored)
+ * @return errorCodes_t noError or error code
+ */
+errorCodes_t graph_ctx_parse(graph_ctx_t *ctx, FILE *stream, bool streaming)
+{
+    parse_arguments_t arguments = {.stream = stream, .streaming = streaming};
+    return graph_ctx_run(ctx, graph_ctx_parse_operation, &arguments);
+}
+
+/**
+ * @brief Internal analysis operation.
+ * @param argument unused
+ */
+void graph_ctx_analyze_operation(void *argument)
+{
+    (void)argument;
+    if (!graph_ctx_current()->graph)
+    {
+        error_exit(internalError, "Graph was not read\n");
+    }
+    if (graph_is_streaming())
+    {
+        graph_analyze_streaming_properties();
+    }
+    else
+    {
+        graph_analyze_properties();
+    }
+}
+
+/**
+ * @brief Function analyzes graph of context and prints its properties to context output.
+ * @param ctx context
+ * @return errorCodes_t noError or error code
+ */
+errorCodes_t graph_ctx_analyze(graph_ctx_t *ctx)
+{
+    return graph_ctx_run(ctx, graph_ctx_analyze_operation, NULL);
+}
+
+/**
+ * @brief Internal binary write operation.
+ * @param argument output stream
+ */
+void graph_ctx_write_binary_operation(void *argument)
+{
+    if (!graph_ctx_current()->graph)
+    {
+        error_exit(internalError, "Graph was not read\n");
+    }
+    graph_write_binary((FILE *)argument);
+}
+
+/**
+ * @brief Function writes graph of context to stream in binary graph format.
+ * @param ctx context
+ * @param stream output stream
+ * @return errorCodes_t noError or error code
+ */
+errorCodes_t graph_ctx_write_binary(graph_ctx_t *ctx, FILE *stream)
+{
+    return graph_ctx_run(ctx, graph_ctx_write_binary_operation, stream);
+}
+
+/**
+ * @brief Function returns node count of graph of context.
+ * @param ctx context
+ * @return unsigned int node count, 0 when no graph was read
+ */
+unsigned int graph_ctx_get_node_count(graph_ctx_t *ctx)
+{
+    if (!ctx->graph)
+    {
+        return 0;
+    }
+    graph_ctx_t *previous = graph_ctx_bind(ctx);
+    unsigned int node_count = graph_get_node_count();
+    graph_ctx_bind(previous);
+    return node_count;
+}
+
+/**
+ * @brief Function returns edge count of graph of context.
+ * @param ctx context
+ * @return uint64_t edge count, 0 when no graph was read
+ */
+uint64_t graph_ctx_get_edge_count(graph_ctx_t *ctx)
+{
+    if (!ctx->graph)
+    {
+        return 0;
+    }
+    graph_ctx_t *previous = graph_ctx_bind(ctx);
+    uint64_t edge_count = graph_get_edge_count();
+    graph_ctx_bind(previous);
+    return edge_count;
+}
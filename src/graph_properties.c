@@ -11,191 +11,513 @@
  */
 
 #include "../include/graph_properties.h"
-#include <time.h>
+#include "../include/thread_pool.h"
+#include "../include/cycles.h"
+#include "../include/short_cycles.h"
+#include "../include/bitset.h"
+#include "../include/graph_ctx.h"
+#include "../include/timing.h"
+#include "../include/stats.h"
+#include "../include/memory_usage.h"
+#include <inttypes.h>
+
+// answers of streaming analysis, duplicate edges make some properties unknown and counts upper bounds
+#define STREAM_YES "yes"
+#define STREAM_NO "no"
+#define STREAM_UNKNOWN "unknown, input may contain duplicates"
+#define STREAM_UPPER_BOUND "at most %" PRIu64 " (input may contain duplicates)"
 
-clock_t begin, end;
+/**
+ * @brief Printed properties whose runtime is measured.
+ */
+typedef enum measured_property
+{
+	nodeCountProperty,
+	edgeCountProperty,
+	componentCountProperty,
+	cycleCountProperty,
+	maxDegreeProperty,
+	connectedProperty,
+	completeProperty,
+	treeProperty,
+	forestProperty,
+	measuredPropertyCount
+} measured_property_t;
+
+/**
+ * @brief Runtimes of all measured properties in every analysis run, their operation counters and memory.
+ */
+typedef struct measurements
+{
+	// runtimes in nanoseconds, run samples of each property are stored together
+	uint64_t *samples;
+	unsigned int run_count;
+	unsigned int run;
+	// counters of graph parsing and of every property in the last run
+	stats_t parse_stats;
+	stats_t stats[measuredPropertyCount];
+	// memory allocated by every property in the last run
+	memory_phase_t memory[measuredPropertyCount];
+} measurements_t;
+
+/**
+ * @brief Vertex on path of deep first search, its neighbors which are not searched yet.
+ */
+typedef struct search_frame
+{
+	const uint32_t *next;
+	const uint32_t *end;
+} search_frame_t;
+
+/**
+ * @brief Memoized base quantities of analyzed graph, every one of them is computed at most once
+ * and all other properties are derived from them.
+ */
+typedef struct properties
+{
+	bool has_component_count;
+	uint32_t component_count;
+	bool has_max_degree;
+	unsigned int max_degree;
+	bool has_cycle_counts;
+	cycle_counts_t cycle_counts;
+	bool has_short_cycle_counts;
+	cycle_counts_t short_cycle_counts;
+	// running measurements and runtime of the last measured property
+	timing_t timing;
+} properties_t;
 
+/**
+ * @brief Get properties of graph of bound context, they are created on the first use.
+ * @return properties_t* properties
+ */
+properties_t *properties_get_state()
+{
+	graph_ctx_t *ctx = graph_ctx_current();
+	if (!ctx->properties)
+	{
+		ctx->properties = (properties_t *)alloc(1, sizeof(properties_t));
+		alloc_keep(ctx->properties);
+	}
+	return ctx->properties;
+}
+
+/**
+ * @brief Get stream where properties of bound context are printed.
+ * @return FILE* output stream
+ */
+FILE *properties_get_output()
+{
+	FILE *output = graph_ctx_current()->output;
+	return output ? output : stdout;
+}
+
+/**
+ * @brief Start measurement of property runtime, measurements may be nested.
+ */
 void timer_start()
 {
-	begin = clock();
+	timing_start(&properties_get_state()->timing);
 }
 
+/**
+ * @brief Stop the most recently started measurement of property runtime.
+ */
 void timer_stop()
 {
-	end = clock();
+	timing_stop(&properties_get_state()->timing);
 }
 
-void timer_print()
+/**
+ * @brief Prepare storage for runtimes of repeated analysis runs, count of runs is taken from bound context.
+ * @param measurements measurements structure pointer
+ */
+void measurements_init(measurements_t *measurements)
 {
-	printf("\t\truntime: %fs\n", (double)(end - begin) / CLOCKS_PER_SEC);
+	unsigned int run_count = graph_ctx_current()->repeat_count;
+	measurements->run_count = run_count ? run_count : 1;
+	measurements->run = 0;
+	measurements->samples = (uint64_t *)alloc((size_t)measuredPropertyCount * measurements->run_count, sizeof(uint64_t));
+	stats_take(&measurements->parse_stats);
+	memory_usage_collect(NULL);
 }
 
 /**
- * @brief Check if items array contains item, if not, add it.
- * @param item new item to check and add
- * @param items pointer to array with all items
- * @param items_count pointer to items count in array
+ * @brief Release storage of measured runtimes.
+ * @param measurements measurements structure pointer
  */
-void array_add_item(uint64_t item, uint64_t *items, unsigned int *items_count)
+void measurements_destroy(measurements_t *measurements)
 {
-	// xor item with all items to detect if item is already in items array
-	for (unsigned int i = 0; i < *items_count; i++)
+	alloc_free(measurements->samples);
+	measurements->samples = NULL;
+}
+
+/**
+ * @brief Store runtime of the last measurement as runtime of property in current run,
+ * operations counted and memory allocated since the previous property are counted to property.
+ * @param measurements measurements structure pointer
+ * @param property measured property
+ */
+void timer_record(measurements_t *measurements, measured_property_t property)
+{
+	measurements->samples[(size_t)property * measurements->run_count + measurements->run] = properties_get_state()->timing.last;
+	stats_take(&measurements->stats[property]);
+	measurements->memory[property] = (memory_phase_t){0};
+	memory_usage_collect(&measurements->memory[property]);
+}
+
+/**
+ * @brief Print operation counters and memory of graph parsing and memory of graph building
+ * when they are enabled in bound context.
+ * @param measurements measurements structure pointer
+ */
+void parse_report_print(measurements_t *measurements)
+{
+	graph_ctx_t *ctx = graph_ctx_current();
+	FILE *output = properties_get_output();
+	if (ctx->stats_enabled || ctx->memory_enabled)
 	{
-		// item is already in items
-		if ((item ^ items[i]) == 0)
-		{
-			return;
-		}
+		fprintf(output, "Parsing:\n");
+	}
+	if (ctx->stats_enabled)
+	{
+		stats_print(&measurements->parse_stats, output);
+	}
+	if (ctx->memory_enabled)
+	{
+		memory_phase_print(&ctx->parse_memory, output);
+		fprintf(output, "Building:\n");
+		memory_phase_print(&ctx->build_memory, output);
+	}
+}
+
+/**
+ * @brief Print peak resident set size of the process when memory is enabled in bound context.
+ */
+void peak_rss_print()
+{
+	if (graph_ctx_current()->memory_enabled)
+	{
+		fprintf(properties_get_output(), "Peak RSS:\t\t %" PRIu64 " kB\n", memory_usage_peak_rss());
 	}
+}
 
-	// item not found in items, add it
-	// item count has to be retyped to uint64_t to right memory access
-	items[(uint64_t)*items_count] = item;
-	(*items_count)++;
+/**
+ * @brief Print runtime of property, repeated runs are printed as minimum, median and 99th percentile.
+ * Operation counters and memory are printed on the next lines when they are enabled in bound context.
+ * @param measurements measurements structure pointer
+ * @param property measured property
+ */
+void timer_print(measurements_t *measurements, measured_property_t property)
+{
+	FILE *output = properties_get_output();
+	uint64_t *samples = &measurements->samples[(size_t)property * measurements->run_count];
+	if (measurements->run_count == 1)
+	{
+		fprintf(output, "\t\truntime: %.9fs\n", samples[0] / 1e9);
+	}
+	else
+	{
+		timing_summary_t summary;
+		timing_summarize(samples, measurements->run_count, &summary);
+		fprintf(output, "\t\truntime: min %.9fs  median %.9fs  p99 %.9fs\n", summary.min / 1e9, summary.median / 1e9, summary.p99 / 1e9);
+	}
+	if (graph_ctx_current()->stats_enabled)
+	{
+		stats_print(&measurements->stats[property], output);
+	}
+	if (graph_ctx_current()->memory_enabled)
+	{
+		memory_phase_print(&measurements->memory[property], output);
+	}
 }
 
 /**
  * @brief deep first search function
- *  It goes through all neighbors of the inserted nodes,
+ *  It goes through all neighbors of the inserted vertex,
  *  if any of them has already been checked, it skips,
- *  otherwise the selected one is called recursively until all nodes are checked.
- * @param node node to be searched
- * @param visited bit array of visited nodes
+ *  otherwise the selected one is pushed to path until all vertices are checked.
+ *  Path is kept on explicit stack, so search depth is not limited by thread stack.
+ * @param vertex vertex to be searched
+ * @param visited array of visited flags indexed by vertex
+ * @param stack path stack with space for all vertices
+ * @return uint32_t count of newly visited vertices
  */
-void deep_first_search(node_t *node, uint64_t *visited)
+uint32_t deep_first_search(uint32_t vertex, bool *visited, search_frame_t *stack)
 {
-	uint64_t current_node_bit = (uint64_t)1 << graph_get_node_index(node);
-
-	// if node is already visited, return visited nodes
-	if (current_node_bit & *visited)
+	// if vertex is already visited, return visited vertices
+	if (visited[vertex])
 	{
-		return;
+		return 0;
 	}
 
-	// mark node as visited
-	*visited |= current_node_bit;
+	// mark vertex as visited, neighbors of the last vertex of path are kept in locals
+	visited[vertex] = true;
+	uint32_t visited_count = 1;
+	uint32_t stack_size = 1;
+	vertex_span_t neighbors = graph_get_vertex_neighbors(vertex);
+	const uint32_t *next = neighbors.ids;
+	const uint32_t *end = neighbors.ids + neighbors.count;
+	STATS_ENTER();
+	STATS_ADD(vertexVisitsCounter, 1);
+	STATS_ADD(edgeRelaxationsCounter, neighbors.count);
+
+	while (true)
+	{
+		// go through remaining neighbors, unvisited neighbor is pushed to path and searched first
+		while (next != end)
+		{
+			uint32_t neighbor = *next++;
+			if (visited[neighbor])
+			{
+				continue;
+			}
+
+			stack[stack_size - 1] = (search_frame_t){.next = next, .end = end};
+			visited[neighbor] = true;
+			visited_count++;
+			stack_size++;
+			neighbors = graph_get_vertex_neighbors(neighbor);
+			next = neighbors.ids;
+			end = neighbors.ids + neighbors.count;
+			STATS_ENTER();
+			STATS_ADD(vertexVisitsCounter, 1);
+			STATS_ADD(edgeRelaxationsCounter, neighbors.count);
+		}
 
-	unsigned int node_edge_count = node_get_edge_count(node);
+		STATS_LEAVE();
+		if (--stack_size == 0)
+		{
+			return visited_count;
+		}
 
-	// go through all neighbors
-	for (unsigned int i = 0; i < node_edge_count; i++)
-	{
-		deep_first_search(node_get_edge_node_by_index(node, i), visited);
+		// continue with the previous vertex of path
+		next = stack[stack_size - 1].next;
+		end = stack[stack_size - 1].end;
 	}
 }
 
 /**
- * @brief Get factorial of a number
- * @param n number to get factorial of
- * @return unsigned int result of factorial
+ * @brief Count connected components over adjacency matrix of dense graph. Unvisited vertices are kept in a bitset
+ * and all unvisited neighbors of searched vertex are taken from it by one vectorized AND with its row,
+ * then set bits of taken neighbors are iterated.
+ *
+ * Time complexity: O(|V|^2 / 64)
+ * @return uint32_t component count
  */
-unsigned int fact(int n)
+uint32_t matrix_get_component_count()
 {
-	if (n < 2)
+	uint32_t node_count = graph_get_node_count();
+	size_t word_count = graph_get_matrix_row_word_count();
+	uint64_t *unvisited = (uint64_t *)alloc(word_count, sizeof(uint64_t));
+	uint64_t *taken = (uint64_t *)alloc(word_count, sizeof(uint64_t));
+	uint32_t *stack = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		unvisited[i / BITSET_WORD_BITS] |= (uint64_t)1 << (i % BITSET_WORD_BITS);
+	}
+
+	uint32_t component_count = 0;
+	for (uint32_t start = bitset_next(unvisited, word_count, 0); start != BITSET_NONE; start = bitset_next(unvisited, word_count, start))
 	{
-		return 1;
+		unvisited[start / BITSET_WORD_BITS] &= ~((uint64_t)1 << (start % BITSET_WORD_BITS));
+		component_count++;
+
+		uint32_t stack_size = 0;
+		stack[stack_size++] = start;
+		while (stack_size != 0)
+		{
+			uint32_t vertex = stack[--stack_size];
+			STATS_ADD(vertexVisitsCounter, 1);
+			if (!bitset_take(unvisited, graph_get_vertex_row(vertex), taken, word_count))
+			{
+				continue;
+			}
+			for (uint32_t neighbor = bitset_next(taken, word_count, 0); neighbor != BITSET_NONE; neighbor = bitset_next(taken, word_count, neighbor + 1))
+			{
+				stack[stack_size++] = neighbor;
+			}
+		}
 	}
 
-	return n * fact(n - 1);
+	alloc_free(unvisited);
+	alloc_free(taken);
+	alloc_free(stack);
+	return component_count;
 }
 
 /**
- * @brief Get the max cycle count
- * @param n node count
- * @param r max size of cycle
- * @return unsigned int max cycle count
+ * @brief Forget all computed properties, must be called when analyzed graph changes.
  */
-unsigned int get_max_cycle_count(int n, int r)
+void graph_properties_reset()
 {
-	// minimal cycle size is 3
-	if (r < 3 || n < 3)
+	properties_t *properties = properties_get_state();
+	if (properties->has_cycle_counts)
 	{
-		return 0;
+		cycle_counts_destroy(&properties->cycle_counts);
 	}
-
-	// cycle count (r nodes in cycle of n nodes)  n!/((n-r)!*r!)
-	// recursive (cycle count for r size) + (cycle count for r-1 size) + ...
-	return (fact(n) / (fact(n - r) * fact(r))) + get_max_cycle_count(n, r - 1);
+	if (properties->has_short_cycle_counts)
+	{
+		cycle_counts_destroy(&properties->short_cycle_counts);
+	}
+	*properties = (properties_t){0};
 }
 
 /**
- * @brief Get all cycles in graph with deep search
- * @param node node to be searched
- * @param start_node_index index of start node
- * @param visited visited nodes bit array
- * @param visited_count count of visited nodes
- * @param cycles pointer to bit array with all cycles
- * @param cycles_count pointer to count of all cycles in array
+ * @brief Forget all computed properties and release their storage in bound context.
  */
-void search_all_cycles(node_t *node, unsigned int start_node_index, uint64_t visited, unsigned int visited_count, uint64_t *cycles, unsigned int *cycles_count)
+void graph_properties_destroy()
 {
-	uint64_t current_node_bit = (uint64_t)1 << graph_get_node_index(node);
+	graph_ctx_t *ctx = graph_ctx_current();
+	if (ctx->properties)
+	{
+		graph_properties_reset();
+		alloc_free(ctx->properties);
+		ctx->properties = NULL;
+	}
+}
 
-	// if node is already visited, return visited nodes
-	if (current_node_bit & visited)
+/**
+ * @brief Get memoized count of connected components, deep first search is started from every unvisited vertex,
+ * dense graphs are searched over their adjacency matrix.
+ *
+ * Time complexity: O(|V|+|E|) or O(|V|^2 / 64) for dense graphs first time, O(1) afterwards
+ * @return uint32_t component count
+ */
+uint32_t properties_get_component_count()
+{
+	properties_t *properties = properties_get_state();
+	if (!properties->has_component_count && graph_has_adjacency_matrix())
 	{
-		uint64_t start_node_bit = (uint64_t)1 << start_node_index;
+		properties->component_count = matrix_get_component_count();
+		properties->has_component_count = true;
+	}
+	if (!properties->has_component_count)
+	{
+		uint32_t node_count = graph_get_node_count();
+		bool *visited = (bool *)alloc(node_count, sizeof(bool));
+		search_frame_t *stack = (search_frame_t *)alloc(node_count, sizeof(search_frame_t));
 
-		// cycle must be of at least 3 nodes
-		if ((current_node_bit & start_node_bit) && (visited_count > 2))
+		properties->component_count = 0;
+		for (uint32_t i = 0; i < node_count; i++)
 		{
-			array_add_item(visited, cycles, cycles_count);
+			if (!visited[i])
+			{
+				deep_first_search(i, visited, stack);
+				properties->component_count++;
+			}
 		}
-		return;
+
+		alloc_free(visited);
+		alloc_free(stack);
+		properties->has_component_count = true;
 	}
+	return properties->component_count;
+}
 
-	// increment nodes visited
-	visited_count++;
-	// mark node as visited
-	visited |= current_node_bit;
+/**
+ * @brief Get memoized maximum degree, loops through all vertices and selects the largest degree.
+ *
+ * Time complexity: O(|V|) first time, O(1) afterwards
+ * @return unsigned int maximum degree
+ */
+unsigned int properties_get_max_degree()
+{
+	properties_t *properties = properties_get_state();
+	if (!properties->has_max_degree)
+	{
+		uint32_t node_count = graph_get_node_count();
 
-	unsigned int node_edge_count = node_get_edge_count(node);
+		properties->max_degree = 0;
+		for (uint32_t i = 0; i < node_count; i++)
+		{
+			unsigned int degree = graph_get_vertex_degree(i);
 
-	// go through all neighbors
-	for (unsigned int i = 0; i < node_edge_count; i++)
-	{
-		search_all_cycles(node_get_edge_node_by_index(node, i), start_node_index, visited, visited_count, cycles, cycles_count);
+			if (properties->max_degree < degree)
+			{
+				properties->max_degree = degree;
+			}
+		}
+		properties->has_max_degree = true;
 	}
+	return properties->max_degree;
 }
 
 /**
- * @brief Get all edges in graph
- * @param node node to be searched
- * @param edges pointer to bit array with all edges
- * @param edges_count pointer to count of all edges in array
+ * @brief Get memoized counts of all simple cycles by length.
+ * Graph is decomposed to biconnected components, small dense components are counted with subset DP,
+ * others with Johnson's cycle enumeration.
+ *
+ * Time complexity: O(|V|+|E|) for graphs with at most one cycle in each block,
+ * O((|V|+|E|)(C+1)), C = number of cycles, or O(2^|V| * |V|^2) for small dense blocks, O(1) afterwards
+ * @return const cycle_counts_t* cycle counts, valid until graph_properties_reset
  */
-void search_all_edges(node_t *node, uint64_t *edges, unsigned int *edges_count)
+const cycle_counts_t *properties_get_cycle_counts()
 {
-	uint64_t current_node_bit = (uint64_t)1 << graph_get_node_index(node);
-
-	unsigned int node_edge_count = node_get_edge_count(node);
+	properties_t *properties = properties_get_state();
+	if (!properties->has_cycle_counts)
+	{
+		cycle_counts_init(&properties->cycle_counts, graph_get_node_count());
+		cycles_count(graph_ctx_current()->thread_count, &properties->cycle_counts);
+		properties->has_cycle_counts = true;
+	}
+	return &properties->cycle_counts;
+}
 
-	// go through all neighbors
-	for (unsigned int i = 0; i < node_edge_count; i++)
+/**
+ * @brief Get memoized counts of simple cycles up to cycle length limit of bound context by length,
+ * counted by short cycle kernels without enumerating cycles.
+ *
+ * Time complexity: O(|E| * sqrt(|E|)) for lengths up to 4, O(|V| * D^(k-1)) for longer cycles up to k,
+ * D = maximum degree, O(1) afterwards
+ * @return const cycle_counts_t* cycle counts, valid until graph_properties_reset
+ */
+const cycle_counts_t *properties_get_short_cycle_counts()
+{
+	properties_t *properties = properties_get_state();
+	if (!properties->has_short_cycle_counts)
 	{
-		uint64_t neighbor_node_bit = (uint64_t)1 << graph_get_node_index(node_get_edge_node_by_index(node, i));
-		array_add_item((current_node_bit | neighbor_node_bit), edges, edges_count);
+		uint32_t node_count = graph_get_node_count();
+		unsigned int cycle_length_limit = graph_ctx_current()->cycle_length_limit;
+		cycle_counts_init(&properties->short_cycle_counts, cycle_length_limit < node_count ? cycle_length_limit : node_count);
+		if (properties->short_cycle_counts.max_length >= SHORT_CYCLE_MIN_LENGTH)
+		{
+			short_cycles_count(properties->short_cycle_counts.max_length, graph_ctx_current()->thread_count, &properties->short_cycle_counts);
+		}
+		properties->has_short_cycle_counts = true;
 	}
+	return &properties->short_cycle_counts;
 }
 
 /**
- * @brief deep-first search function to determine if the graph is continuous.
+ * @brief Get count of connected components.
  *
  * Time complexity: O(|V|+|E|)
- * @return bool graph is connected
+ * @return uint32_t component count
  */
-bool graph_is_connected()
+uint32_t graph_get_component_count()
 {
 	timer_start();
 
-	// use deep first search from first node
-	uint64_t visited = 0;
+	uint32_t result = properties_get_component_count();
 
-	deep_first_search(graph_get_node_by_index(0), &visited);
+	timer_stop();
+
+	return result;
+}
 
-	uint64_t all_visited = (1 << graph_get_node_count()) - 1;
+/**
+ * @brief Graph is connected if it has exactly one component.
+ *
+ * Time complexity: O(|V|+|E|), O(1) with known component count
+ * @return bool graph is connected
+ */
+bool graph_is_connected()
+{
+	timer_start();
 
-	bool result = (visited == all_visited);
+	bool result = properties_get_component_count() == 1;
 
 	timer_stop();
 
@@ -203,35 +525,25 @@ bool graph_is_connected()
 }
 
 /**
- * @brief Loops through all nodes, compares the number of vertices, compares with the completeness condition.
+ * @brief Graph is complete if it contains all possible edges |V|(|V|-1)/2, duplicate edges are never stored.
  *
- * Time complexity: O(|V|)
+ * Time complexity: O(1)
  * @return bool graph is complete
  */
 bool graph_is_complete()
 {
 	timer_start();
 
-	// max edges for one node -> node_count - 1
-
-	unsigned int node_count = graph_get_node_count();
-	unsigned int max_node_edge_count = node_count - 1;
-
-	for (unsigned int i = 0; i < node_count; i++)
-	{
-		if (node_get_edge_count(graph_get_node_by_index(i)) != max_node_edge_count)
-		{
-			timer_stop();
-			return false;
-		}
-	}
+	uint64_t node_count = graph_get_node_count();
+	bool result = graph_get_edge_count() == node_count * (node_count - 1) / 2;
 
 	timer_stop();
-	return true;
+
+	return result;
 }
 
 /**
- * @brief Loops through all nodes, compares each vertex count, compares and selects the largest vertex.
+ * @brief Get the maximum degree (or valence) of the vertex of the graph.
  *
  * Time complexity: O(|V|)
  * @return unsigned int return the maximum degree (or valence) of the vertex of the graph
@@ -240,22 +552,11 @@ unsigned int graph_get_max_degree()
 {
 	timer_start();
 
-	unsigned int max = 0;
-	unsigned int node_count = graph_get_node_count();
-
-	for (unsigned int i = 0; i < node_count; i++)
-	{
-		unsigned int edge_count = node_get_edge_count(graph_get_node_by_index(i));
-
-		if (max < edge_count)
-		{
-			max = edge_count;
-		}
-	}
+	unsigned int result = properties_get_max_degree();
 
 	timer_stop();
 
-	return max;
+	return result;
 }
 
 /**
@@ -276,94 +577,120 @@ unsigned int graph_get_node_count_wt()
 }
 
 /**
- * @brief Get edges count of graph with deep search.
+ * @brief Get edge count function with timer, edges are counted while graph is created.
  *
- * Time complexity: O(|V|+|E|)
- * @return unsigned int total edge count
+ * Time complexity: O(1)
+ * @return uint64_t total edge count
  */
-unsigned int graph_get_edge_count()
+uint64_t graph_get_edge_count_wt()
 {
 	timer_start();
 
-	// max total edges for all nodes -> node_count * (node_count - 1) / 2
-
-	unsigned int node_count = graph_get_node_count();
-	unsigned int max_edges_count = node_count * (node_count - 1) / 2;
+	uint64_t result = graph_get_edge_count();
 
-	if (max_edges_count == 0)
-	{
-		return 0;
-	}
+	timer_stop();
 
-	// array of edges, one edge is bit array of visited nodes
-	// 0 - not in edge, 1 - in edge
-	uint64_t edges[max_edges_count];
-	for (unsigned int i = 0; i < max_edges_count; i++)
-	{
-		edges[i] = 0;
-	}
+	return result;
+}
 
-	unsigned int edges_count = 0;
+/**
+ * @brief Get counts of all simple cycles in graph by length.
+ *
+ * Time complexity: see properties_get_cycle_counts
+ * @return const cycle_counts_t* cycle counts, valid until graph_properties_reset
+ */
+const cycle_counts_t *graph_get_cycle_length_counts()
+{
+	timer_start();
 
-	for (unsigned int i = 0; (i < node_count) && (edges_count != max_edges_count); i++)
-	{
-		search_all_edges(graph_get_node_by_index(i), edges, &edges_count);
-	}
+	const cycle_counts_t *result = properties_get_cycle_counts();
 
 	timer_stop();
 
-	return edges_count;
+	return result;
+}
+
+/**
+ * @brief Get count of all simple cycles in graph.
+ *
+ * Time complexity: see properties_get_cycle_counts
+ * @return uint64_t total cycle count
+ */
+uint64_t graph_get_cycle_count()
+{
+	return graph_get_cycle_length_counts()->total;
 }
 
 /**
- * @brief Get cycle count of graph with deep search.
+ * @brief Get counts of simple cycles up to set cycle length limit by length, cheaper than counting all cycles.
  *
- * Time complexity: O(|V|+|E|)
- * @return unsigned int total cycle count
+ * Time complexity: see properties_get_short_cycle_counts
+ * @return const cycle_counts_t* cycle counts, valid until graph_properties_reset
  */
-unsigned int graph_get_cycle_count()
+const cycle_counts_t *graph_get_short_cycle_counts()
 {
 	timer_start();
 
-	unsigned int node_count = graph_get_node_count();
-	unsigned int max_cycles_count = get_max_cycle_count(node_count, node_count);
+	const cycle_counts_t *result = properties_get_short_cycle_counts();
 
-	if (max_cycles_count == 0)
+	timer_stop();
+
+	return result;
+}
+
+/**
+ * @brief Get counts of cycles up to cycle length limit of bound context or of all cycles, when counting
+ * exceeds memory limit of bound context, its runtime is measured until the failure and NULL is returned.
+ * @throw Error of counting other than exceeded memory limit.
+ * @param limited cycles are counted up to cycle length limit
+ * @return const cycle_counts_t* cycle counts or NULL, valid until graph_properties_reset
+ */
+const cycle_counts_t *properties_try_cycle_counts(bool limited)
+{
+	graph_ctx_t *ctx = graph_ctx_current();
+	properties_t *properties = properties_get_state();
+	unsigned int timing_depth = properties->timing.depth;
+	uint64_t start = timing_now();
+	uint64_t scope = memory_scope_begin();
+	const cycle_counts_t *volatile result = NULL;
+	jmp_buf jump;
+	jmp_buf *previous_jump = graph_ctx_set_error_jump(&jump);
+	if (setjmp(jump) == 0)
 	{
-		return 0;
+		result = limited ? graph_get_short_cycle_counts() : graph_get_cycle_length_counts();
 	}
-
-	// array of cycles, one cycle is bit array of visited nodes
-	// 0 - not in cycle, 1 - in cycle
-	uint64_t cycles[max_cycles_count];
-	for (unsigned int i = 0; i < max_cycles_count; i++)
+	graph_ctx_set_error_jump(previous_jump);
+	if (result)
 	{
-		cycles[i] = 0;
+		return result;
 	}
 
-	unsigned int cycles_count = 0;
-
-	for (unsigned int i = 0; (i < node_count) && (cycles_count != max_cycles_count); i++)
+	// measurements started by counting were not stopped
+	properties->timing.depth = timing_depth;
+	properties->timing.last = timing_now() - start;
+	if (ctx->error_code != memoryLimitError)
 	{
-		search_all_cycles(graph_get_node_by_index(i), i, 0, 0, cycles, &cycles_count);
+		error_exit(ctx->error_code, "%s", ctx->error_message);
 	}
-
-	timer_stop();
-
-	return cycles_count;
+	ctx->error_code = noError;
+	ctx->error_message[0] = '\0';
+	// counts are not memoized, the rest of memory allocated by counting is freed
+	cycle_counts_destroy(limited ? &properties->short_cycle_counts : &properties->cycle_counts);
+	memory_scope_release(scope);
+	return NULL;
 }
 
 /**
- * @brief Graph is a tree if it has no cycles and is connected.
+ * @brief Graph is a tree if it is connected and has |V|-1 edges, connected graph with |V|-1 edges has no cycles.
  *
- * Time complexity: O(|V|+|E|)
+ * Time complexity: O(|V|+|E|), O(1) with known component count
  * @return bool graph is tree
  */
 bool graph_is_tree()
 {
 	timer_start();
 
-	bool result = graph_get_cycle_count() == 0 && graph_is_connected();
+	bool result = properties_get_component_count() == 1 && graph_get_edge_count() + 1 == graph_get_node_count();
 
 	timer_stop();
 
@@ -371,16 +698,18 @@ bool graph_is_tree()
 }
 
 /**
- * @brief Graph is forest if it has no cycles and is not connected.
+ * @brief Graph is forest if it has no cycles and is not connected,
+ * graph has no cycles when every component is a tree, so it has |V|-C edges (C = component count).
  *
- * Time complexity: O(|V|+|E|)
+ * Time complexity: O(|V|+|E|), O(1) with known component count
  * @return bool graph is forest
  */
 bool graph_is_forest()
 {
 	timer_start();
 
-	bool result = graph_get_cycle_count() == 0 && !graph_is_connected();
+	uint32_t component_count = properties_get_component_count();
+	bool result = component_count != 1 && graph_get_edge_count() + component_count == graph_get_node_count();
 
 	timer_stop();
 
@@ -388,27 +717,213 @@ bool graph_is_forest()
 }
 
 /**
- * @brief analyze graph properties and print them
+ * @brief Set count of threads used for parallel property computation of bound context
+ * @param count thread count, 0 for count of online processors
+ */
+void graph_properties_set_thread_count(unsigned int count)
+{
+	graph_ctx_current()->thread_count = count ? count : thread_pool_get_processor_count();
+}
+
+/**
+ * @brief Set maximal length of counted cycles of bound context, only short cycles are counted instead of all cycles
+ * @param length maximal cycle length, 0 counts all cycles
+ */
+void graph_properties_set_cycle_length_limit(unsigned int length)
+{
+	graph_ctx_current()->cycle_length_limit = length;
+}
+
+/**
+ * @brief analyze graph properties and print them, base quantities are computed once for all properties.
+ * With repeat count of bound context above 1 analysis runs repeatedly from scratch and runtime statistics are printed.
  */
 void graph_analyze_properties()
 {
+	FILE *output = properties_get_output();
+	unsigned int cycle_length_limit = graph_ctx_current()->cycle_length_limit;
+	measurements_t measurements;
+	measurements_init(&measurements);
+
+	unsigned int node_count = 0;
+	uint64_t edge_count = 0;
+	uint32_t component_count = 0;
+	const cycle_counts_t *cycle_counts = NULL;
+	unsigned int max_degree = 0;
+	bool connected = false, complete = false, tree = false, forest = false;
+	for (measurements.run = 0; measurements.run < measurements.run_count; measurements.run++)
+	{
+		graph_properties_reset();
+		node_count = graph_get_node_count_wt();
+		timer_record(&measurements, nodeCountProperty);
+		edge_count = graph_get_edge_count_wt();
+		timer_record(&measurements, edgeCountProperty);
+		component_count = graph_get_component_count();
+		timer_record(&measurements, componentCountProperty);
+		cycle_counts = properties_try_cycle_counts(cycle_length_limit != 0);
+		timer_record(&measurements, cycleCountProperty);
+		max_degree = graph_get_max_degree();
+		timer_record(&measurements, maxDegreeProperty);
+		connected = graph_is_connected();
+		timer_record(&measurements, connectedProperty);
+		complete = graph_is_complete();
+		timer_record(&measurements, completeProperty);
+		tree = graph_is_tree();
+		timer_record(&measurements, treeProperty);
+		forest = graph_is_forest();
+		timer_record(&measurements, forestProperty);
+	}
 
-	printf("===========================================================\n");
-	printf("Node count:\t\t %d", graph_get_node_count_wt());
-	timer_print();
-	printf("Edge count:\t\t %d", graph_get_edge_count());
-	timer_print();
-	printf("Cycle count:\t\t %d", graph_get_cycle_count());
-	timer_print();
-	printf("Maximum degree:\t\t %d", graph_get_max_degree());
-	timer_print();
-	printf("Graph is connected:\t %s", graph_is_connected() ? "yes" : "no");
-	timer_print();
-	printf("Graph is complete:\t %s", graph_is_complete() ? "yes" : "no");
-	timer_print();
-	printf("Graph is tree:\t\t %s", graph_is_tree() ? "yes" : "no");
-	timer_print();
-	printf("Graph is forest\t\t %s", graph_is_forest() ? "yes" : "no");
-	timer_print();
-	printf("===========================================================\n");
+	fprintf(output, "===========================================================\n");
+	parse_report_print(&measurements);
+	fprintf(output, "Node count:\t\t %u", node_count);
+	timer_print(&measurements, nodeCountProperty);
+	fprintf(output, "Edge count:\t\t %" PRIu64, edge_count);
+	timer_print(&measurements, edgeCountProperty);
+	fprintf(output, "Component count:\t %" PRIu32, component_count);
+	timer_print(&measurements, componentCountProperty);
+	if (cycle_length_limit)
+	{
+		fprintf(output, "Cycle count (max %u):\t ", cycle_length_limit);
+	}
+	else
+	{
+		fprintf(output, "Cycle count:\t\t ");
+	}
+	if (cycle_counts)
+	{
+		fprintf(output, "%" PRIu64, cycle_counts->total);
+	}
+	else
+	{
+		fprintf(output, "not computed (memory limit exceeded)");
+	}
+	timer_print(&measurements, cycleCountProperty);
+	for (uint32_t length = 3; cycle_counts && length <= cycle_counts->max_length; length++)
+	{
+		if (cycle_counts->by_length[length])
+		{
+			fprintf(output, "  of length %u:\t\t %" PRIu64 "\n", length, cycle_counts->by_length[length]);
+		}
+	}
+	fprintf(output, "Maximum degree:\t\t %u", max_degree);
+	timer_print(&measurements, maxDegreeProperty);
+	fprintf(output, "Graph is connected:\t %s", connected ? "yes" : "no");
+	timer_print(&measurements, connectedProperty);
+	fprintf(output, "Graph is complete:\t %s", complete ? "yes" : "no");
+	timer_print(&measurements, completeProperty);
+	fprintf(output, "Graph is tree:\t\t %s", tree ? "yes" : "no");
+	timer_print(&measurements, treeProperty);
+	fprintf(output, "Graph is forest\t\t %s", forest ? "yes" : "no");
+	timer_print(&measurements, forestProperty);
+	peak_rss_print();
+	fprintf(output, "===========================================================\n");
+
+	measurements_destroy(&measurements);
+	graph_properties_reset();
+}
+
+/**
+ * @brief analyze streaming graph properties and print them.
+ * Components were merged while edges were read, so all properties are computed without adjacency.
+ * Edge which joined 2 nodes of the same component closed a cycle or repeated an earlier edge, duplicates
+ * can not be told apart from cycles without adjacency. Once such edge was read, edge count and maximum degree
+ * may include duplicates and are printed as upper bounds, completeness, tree and forest properties are printed
+ * as unknown unless the component count or too few edges decide them.
+ * With repeat count of bound context above 1 properties are computed repeatedly and runtime statistics are printed.
+ *
+ * Time complexity: O(1) for each property except maximum degree O(|V|)
+ */
+void graph_analyze_streaming_properties()
+{
+	FILE *output = properties_get_output();
+	measurements_t measurements;
+	measurements_init(&measurements);
+
+	uint64_t node_count = 0;
+	uint64_t edge_count = 0;
+	uint32_t component_count = 0;
+	unsigned int max_degree = 0;
+	bool connected = false;
+	// edge closing a cycle may be a duplicate, edges and degrees are then counted with duplicates
+	bool duplicates = false;
+	const char *complete = STREAM_NO, *tree = STREAM_NO, *forest = STREAM_NO;
+	for (measurements.run = 0; measurements.run < measurements.run_count; measurements.run++)
+	{
+		graph_properties_reset();
+		node_count = graph_get_node_count_wt();
+		timer_record(&measurements, nodeCountProperty);
+
+		timer_start();
+		edge_count = graph_get_edge_count();
+		duplicates = graph_stream_has_cycle();
+		timer_stop();
+		timer_record(&measurements, edgeCountProperty);
+
+		timer_start();
+		component_count = graph_stream_get_component_count();
+		timer_stop();
+		timer_record(&measurements, componentCountProperty);
+
+		max_degree = graph_get_max_degree();
+		timer_record(&measurements, maxDegreeProperty);
+
+		timer_start();
+		connected = component_count == 1;
+		timer_stop();
+		timer_record(&measurements, connectedProperty);
+
+		// duplicates only add edges, so too few edges always mean the graph is not complete
+		timer_start();
+		complete = edge_count < node_count * (node_count - 1) / 2 ? STREAM_NO : duplicates ? STREAM_UNKNOWN : STREAM_YES;
+		timer_stop();
+		timer_record(&measurements, completeProperty);
+
+		timer_start();
+		tree = !connected ? STREAM_NO : duplicates ? STREAM_UNKNOWN : STREAM_YES;
+		timer_stop();
+		timer_record(&measurements, treeProperty);
+
+		timer_start();
+		forest = connected ? STREAM_NO : duplicates ? STREAM_UNKNOWN : STREAM_YES;
+		timer_stop();
+		timer_record(&measurements, forestProperty);
+	}
+
+	fprintf(output, "===========================================================\n");
+	parse_report_print(&measurements);
+	fprintf(output, "Node count:\t\t %" PRIu64, node_count);
+	timer_print(&measurements, nodeCountProperty);
+	if (duplicates)
+	{
+		fprintf(output, "Edge count:\t\t " STREAM_UPPER_BOUND, edge_count);
+	}
+	else
+	{
+		fprintf(output, "Edge count:\t\t %" PRIu64, edge_count);
+	}
+	timer_print(&measurements, edgeCountProperty);
+	fprintf(output, "Component count:\t %" PRIu32, component_count);
+	timer_print(&measurements, componentCountProperty);
+	if (duplicates)
+	{
+		fprintf(output, "Maximum degree:\t\t " STREAM_UPPER_BOUND, (uint64_t)max_degree);
+	}
+	else
+	{
+		fprintf(output, "Maximum degree:\t\t %u", max_degree);
+	}
+	timer_print(&measurements, maxDegreeProperty);
+	fprintf(output, "Graph is connected:\t %s", connected ? STREAM_YES : STREAM_NO);
+	timer_print(&measurements, connectedProperty);
+	fprintf(output, "Graph is complete:\t %s", complete);
+	timer_print(&measurements, completeProperty);
+	fprintf(output, "Graph is tree:\t\t %s", tree);
+	timer_print(&measurements, treeProperty);
+	fprintf(output, "Graph is forest\t\t %s", forest);
+	timer_print(&measurements, forestProperty);
+	peak_rss_print();
+	fprintf(output, "===========================================================\n");
+
+	measurements_destroy(&measurements);
 }
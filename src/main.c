@@ -9,9 +9,12 @@
  *
  */
 #include <stdio.h>
+#include <inttypes.h>
 #include "../include/parser.h"
 #include "../include/graph_properties.h"
-#include "../include/resources.h"
+#include "../include/short_cycles.h"
+#include "../include/graph_ctx.h"
+#include "../include/batch.h"
 
 /**
  * @brief Print program help message
@@ -19,8 +22,120 @@
 void print_help()
 {
     printf("Program reads unoriented graph from stdin and analyze and print it's properties to stdout in formated output\n");
-    printf("This help message is printed when program run contains argument.\n");
+    printf("This help message is printed when program run contains unknown argument.\n");
     printf("Run example (from project dir): ./graph_properties < testData/graphComplete\n");
+    printf("Options:\n");
+    printf("  --threads N\tcount cycles with N threads (0 = all processors, default 1)\n");
+    printf("  --cycles-upto K\tcount only cycles of length 3 to K (3 <= K <= 32) by length, much faster than counting all cycles\n");
+    printf("  --repeat N\trun analysis N times and print minimum, median and 99th percentile of property runtimes\n");
+    printf("  --stats\tprint operation counters of parsing and every property (program must be built with make STATS=1)\n");
+    printf("  --memory\tprint memory allocated by parsing, building and every property and peak resident set size\n");
+    printf("  --mem-limit B\tlimit allocated memory to B bytes (suffix K, M or G), cycles which do not fit are not counted\n");
+    printf("  --streaming\tmerge edges into components while reading, without storing them (O(|V|) memory),\n");
+    printf("             \tcycles are not counted, duplicate edges can not be told apart from cycles, so once an edge\n");
+    printf("             \tcloses a cycle edge count and maximum degree are printed as upper bounds, completeness,\n");
+    printf("             \ttree and forest as unknown unless component or edge count decides them\n");
+    printf("  --format F\tinput format: auto (default), graph, gbin (binary graph), edges (\"u v\" lines),\n");
+    printf("             \tdimacs (\"p edge n m\" and \"e u v\" lines) or mtx (Matrix Market coordinate)\n");
+    printf("  --convert IN OUT\twrite graph from file IN to file OUT in binary format, binary graph\n");
+    printf("             \tis recognized on stdin and loaded without parsing\n");
+    printf("  --batch [PATH...]\tanalyze all graph files and directories (must be the last option) or graphs\n");
+    printf("             \tconcatenated on stdin in parallel, results are printed in order after their source name,\n");
+    printf("             \t--threads sets count of graphs analyzed at once (default all processors)\n");
+}
+
+/**
+ * @brief Print error of the last failed call of graph context
+ * @param ctx graph context
+ * @return errorCodes_t error code
+ */
+errorCodes_t print_error(graph_ctx_t *ctx)
+{
+    fflush(stdout);
+    fprintf(stderr, "Error: %s", graph_ctx_get_error(ctx));
+    return ctx->error_code;
+}
+
+/**
+ * @brief Convert graph file to binary graph file
+ * @param ctx graph context
+ * @param inputPath path of the graph file (text or binary)
+ * @param outputPath path of the binary graph file
+ * @return errorCodes_t noError or error code
+ */
+errorCodes_t convert_graph(graph_ctx_t *ctx, const char *inputPath, const char *outputPath)
+{
+    FILE *input = fopen(inputPath, "rb");
+    if (!input)
+    {
+        error_exit(fileAccessError, "File '%s' can not be opened\n", inputPath);
+    }
+    errorCodes_t code = graph_ctx_parse(ctx, input, false);
+    fclose(input);
+    if (code != noError)
+    {
+        return print_error(ctx);
+    }
+
+    FILE *output = fopen(outputPath, "wb");
+    if (!output)
+    {
+        error_exit(fileAccessError, "File '%s' can not be opened\n", outputPath);
+    }
+    code = graph_ctx_write_binary(ctx, output);
+    if (fclose(output) != 0 && code == noError)
+    {
+        error_exit(fileAccessError, "File '%s' can not be written\n", outputPath);
+    }
+    if (code != noError)
+    {
+        return print_error(ctx);
+    }
+
+    printf("Converted %u nodes and %" PRIu64 " edges to '%s'\n", graph_ctx_get_node_count(ctx), graph_ctx_get_edge_count(ctx), outputPath);
+    return noError;
+}
+
+/**
+ * @brief Parse unsigned number program argument
+ * @param arg argument string
+ * @param value pointer where parsed value is stored
+ * @return bool argument is a valid unsigned number
+ */
+bool parse_unsigned_arg(const char *arg, unsigned int *value)
+{
+    char *end = NULL;
+    unsigned long parsed = strtoul(arg, &end, 10);
+    if (*arg < '0' || *arg > '9' || *end != '\0' || parsed > UINT32_MAX)
+    {
+        return false;
+    }
+    *value = (unsigned int)parsed;
+    return true;
+}
+
+/**
+ * @brief Parse byte size program argument, number may be followed by suffix K, M or G (powers of 1024)
+ * @param arg argument string
+ * @param value pointer where parsed value is stored
+ * @return bool argument is a valid byte size
+ */
+bool parse_size_arg(const char *arg, uint64_t *value)
+{
+    char *end = NULL;
+    unsigned long long parsed = strtoull(arg, &end, 10);
+    unsigned int shift = 0;
+    if (*end == 'K' || *end == 'M' || *end == 'G')
+    {
+        shift = *end == 'K' ? 10 : *end == 'M' ? 20 : 30;
+        end++;
+    }
+    if (*arg < '0' || *arg > '9' || *end != '\0' || parsed > UINT64_MAX >> shift)
+    {
+        return false;
+    }
+    *value = (uint64_t)parsed << shift;
+    return true;
 }
 
 /**
@@ -29,20 +144,96 @@ void print_help()
  */
 int main(int argc, char *argv[])
 {
-    if (argc > 1)
+    bool streaming = false;
+    batch_options_t batch_options = {0};
+    graph_ctx_t *ctx = graph_ctx_create();
+    if (!ctx)
     {
-        // ignore unused parameter warning
-        (void)argv;
-
-        print_help();
-        return 0;
+        error_exit(internalError, "Memory allocation failed\n");
     }
 
-    parse_data(stdin);
+    for (int i = 1; i < argc; i++)
+    {
+        unsigned int value = 0;
+        uint64_t size = 0;
 
-    graph_analyze_properties();
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && parse_unsigned_arg(argv[i + 1], &value))
+        {
+            graph_ctx_set_thread_count(ctx, value);
+            batch_options.thread_count = ctx->thread_count;
+            i++;
+        }
+        else if (strcmp(argv[i], "--cycles-upto") == 0 && i + 1 < argc && parse_unsigned_arg(argv[i + 1], &value) && value >= SHORT_CYCLE_MIN_LENGTH && value <= SHORT_CYCLE_MAX_LENGTH)
+        {
+            graph_ctx_set_cycle_length_limit(ctx, value);
+            batch_options.cycle_length_limit = value;
+            i++;
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc && parse_unsigned_arg(argv[i + 1], &value) && value != 0)
+        {
+            graph_ctx_set_repeat_count(ctx, value);
+            batch_options.repeat_count = value;
+            i++;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            if (!graph_ctx_set_stats(ctx, true))
+            {
+                warning_print("Operation counters are not compiled in, build with make STATS=1\n");
+            }
+            batch_options.stats = true;
+        }
+        else if (strcmp(argv[i], "--memory") == 0)
+        {
+            graph_ctx_set_memory_report(ctx, true);
+            batch_options.memory = true;
+        }
+        else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc && parse_size_arg(argv[i + 1], &size) && size != 0)
+        {
+            graph_ctx_set_memory_limit(ctx, size);
+            batch_options.memory_limit = size;
+            i++;
+        }
+        else if (strcmp(argv[i], "--streaming") == 0)
+        {
+            streaming = true;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && graph_ctx_set_format(ctx, argv[i + 1]))
+        {
+            batch_options.format = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--batch") == 0)
+        {
+            batch_options.streaming = streaming;
+            graph_ctx_destroy(ctx);
+            return batch_run((const char *const *)&argv[i + 1], (unsigned int)(argc - i - 1), stdin, &batch_options, stdout);
+        }
+        else if (strcmp(argv[i], "--convert") == 0 && i + 2 < argc)
+        {
+            errorCodes_t code = convert_graph(ctx, argv[i + 1], argv[i + 2]);
+            graph_ctx_destroy(ctx);
+            return code;
+        }
+        else
+        {
+            print_help();
+            graph_ctx_destroy(ctx);
+            return 0;
+        }
+    }
+
+    errorCodes_t code = graph_ctx_parse(ctx, stdin, streaming);
+    if (code == noError)
+    {
+        code = graph_ctx_analyze(ctx);
+    }
+    if (code != noError)
+    {
+        print_error(ctx);
+    }
 
-    FREE_RESOURCES;
+    graph_ctx_destroy(ctx);
 
-    return 0;
+    return code;
 }
@@ -0,0 +1,209 @@
+/**
+ * @file memory_usage.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for accounting of allocated memory by phases of analysis,
+ * every tracked allocation and release updates counters of graph context bound to the calling thread
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <inttypes.h>
+#include "../include/memory_usage.h"
+#include "../include/graph_ctx.h"
+
+/**
+ * @brief Function counts allocation of bytes to bound graph context.
+ * @throw Error when live bytes would exceed memory limit of the context.
+ * @param bytes allocated bytes
+ */
+void memory_usage_allocate(uint64_t bytes)
+{
+    memory_usage_t *memory = &graph_ctx_current()->memory;
+    uint64_t current = __atomic_add_fetch(&memory->current, bytes, __ATOMIC_RELAXED);
+    if (memory->limit != 0 && current > memory->limit)
+    {
+        __atomic_sub_fetch(&memory->current, bytes, __ATOMIC_RELAXED);
+        error_exit(memoryLimitError, "Memory limit of %" PRIu64 " bytes exceeded\n", memory->limit);
+    }
+    __atomic_add_fetch(&memory->allocated, bytes, __ATOMIC_RELAXED);
+    uint64_t peak = __atomic_load_n(&memory->peak, __ATOMIC_RELAXED);
+    while (peak < current && !__atomic_compare_exchange_n(&memory->peak, &peak, current, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/**
+ * @brief Function counts release of bytes to bound graph context.
+ * @param bytes released bytes
+ */
+void memory_usage_release(uint64_t bytes)
+{
+    __atomic_sub_fetch(&graph_ctx_current()->memory.current, bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Function returns if bytes can be allocated without exceeding memory limit of bound graph context,
+ * so optional memory can be skipped instead of failing.
+ * @param bytes bytes to allocate
+ * @return bool allocation fits in memory limit
+ */
+bool memory_usage_fits(uint64_t bytes)
+{
+    memory_usage_t *memory = &graph_ctx_current()->memory;
+    return memory->limit == 0 || __atomic_load_n(&memory->current, __ATOMIC_RELAXED) + bytes <= memory->limit;
+}
+
+/**
+ * @brief Function adds bytes allocated since the last collection to phase and starts a new collection.
+ * @param phase phase structure pointer, NULL forgets collected memory
+ */
+void memory_usage_collect(memory_phase_t *phase)
+{
+    memory_usage_t *memory = &graph_ctx_current()->memory;
+    uint64_t allocated = __atomic_exchange_n(&memory->allocated, 0, __ATOMIC_RELAXED);
+    uint64_t peak = __atomic_exchange_n(&memory->peak, __atomic_load_n(&memory->current, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    if (phase)
+    {
+        phase->allocated += allocated;
+        phase->peak = peak > phase->peak ? peak : phase->peak;
+    }
+}
+
+/**
+ * @brief Function returns peak resident set size of the process.
+ * @return uint64_t peak resident set size in kilobytes, 0 when it is not known
+ */
+uint64_t memory_usage_peak_rss()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return (uint64_t)usage.ru_maxrss;
+}
+
+/**
+ * @brief Function prints memory of phase on one line.
+ * @param phase phase structure pointer
+ * @param output output stream
+ */
+void memory_phase_print(const memory_phase_t *phase, FILE *output)
+{
+    fprintf(output, "  memory: allocated %" PRIu64 " B, peak live %" PRIu64 " B\n", phase->allocated, phase->peak);
+}
+
+/**
+ * @brief Function links block to live blocks of its owner. New block gets bound graph context as owner
+ * and the next sequence of the context, reallocated block keeps both.
+ * @param block block header, owner is NULL for a new block
+ */
+void memory_block_attach(memory_block_t *block)
+{
+    bool allocated = !block->owner;
+    if (allocated)
+    {
+        block->owner = graph_ctx_current();
+    }
+    memory_usage_t *memory = &block->owner->memory;
+    pthread_mutex_lock(&memory->lock);
+    if (allocated)
+    {
+        block->sequence = ++memory->sequence;
+    }
+    block->previous = NULL;
+    block->next = memory->blocks;
+    if (memory->blocks)
+    {
+        memory->blocks->previous = block;
+    }
+    memory->blocks = block;
+    pthread_mutex_unlock(&memory->lock);
+}
+
+/**
+ * @brief Internal function unlinks block from live blocks of its owner, lock of the owner is held.
+ * @param memory memory of owner context
+ * @param block block header
+ */
+void memory_block_unlink(memory_usage_t *memory, memory_block_t *block)
+{
+    if (block->previous)
+    {
+        block->previous->next = block->next;
+    }
+    else
+    {
+        memory->blocks = block->next;
+    }
+    if (block->next)
+    {
+        block->next->previous = block->previous;
+    }
+}
+
+/**
+ * @brief Function unlinks block from live blocks of its owner before it is freed or reallocated.
+ * @param block block header
+ */
+void memory_block_detach(memory_block_t *block)
+{
+    memory_usage_t *memory = &block->owner->memory;
+    pthread_mutex_lock(&memory->lock);
+    memory_block_unlink(memory, block);
+    pthread_mutex_unlock(&memory->lock);
+}
+
+/**
+ * @brief Function marks block as memory kept by its owner context, so it is not freed with scope it was allocated in.
+ * @param block block header
+ */
+void memory_block_keep(memory_block_t *block)
+{
+    memory_usage_t *memory = &block->owner->memory;
+    pthread_mutex_lock(&memory->lock);
+    block->sequence = 0;
+    pthread_mutex_unlock(&memory->lock);
+}
+
+/**
+ * @brief Function starts scope of blocks allocated by bound graph context from now on.
+ * @return uint64_t scope passed to memory_scope_release
+ */
+uint64_t memory_scope_begin()
+{
+    memory_usage_t *memory = &graph_ctx_current()->memory;
+    pthread_mutex_lock(&memory->lock);
+    uint64_t scope = memory->sequence;
+    pthread_mutex_unlock(&memory->lock);
+    return scope;
+}
+
+/**
+ * @brief Function frees live blocks allocated by bound graph context in scope, except kept blocks,
+ * so memory of unwound call is released. Blocks must not be used by any thread.
+ * @param scope scope returned by memory_scope_begin, 0 frees all blocks which are not kept
+ */
+void memory_scope_release(uint64_t scope)
+{
+    memory_usage_t *memory = &graph_ctx_current()->memory;
+    pthread_mutex_lock(&memory->lock);
+    memory_block_t *block = memory->blocks;
+    while (block)
+    {
+        memory_block_t *next = block->next;
+        if (block->sequence > scope)
+        {
+            memory_block_unlink(memory, block);
+            __atomic_sub_fetch(&memory->current, block->size, __ATOMIC_RELAXED);
+            free(block);
+        }
+        block = next;
+    }
+    pthread_mutex_unlock(&memory->lock);
+}
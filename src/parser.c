@@ -9,51 +9,359 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <inttypes.h>
 #include "../include/parser.h"
+#include "../include/tokenizer.h"
+#include "../include/graph_ctx.h"
+#include "../include/stats.h"
+
+// size of read buffer for input which can not be mapped (pipe, terminal)
+#define READ_BUFFER_SIZE (1 << 20)
+// no name is being read
+#define NAME_NONE SIZE_MAX
+// maximal length of keyword in line based formats
+#define MAX_KEYWORD_LENGTH 32
+// count of edge list node numbers allowed beyond the nodes of already read edges,
+// node count of edge list is largest number + 1, so one sparse number would allocate all nodes below it
+#define EDGE_LIST_MAX_NUMBER_GAP (1u << 24)
+#define MATRIX_MARKET_BANNER "%%MatrixMarket"
+
+/**
+ * @brief Supported input formats, numbered formats (edge list, DIMACS, Matrix Market)
+ * use vertex numbers as node indexes without name hashing.
+ */
+typedef enum input_format
+{
+    INPUT_FORMAT_AUTO,
+    INPUT_FORMAT_GRAPH,
+    INPUT_FORMAT_BINARY,
+    INPUT_FORMAT_EDGE_LIST,
+    INPUT_FORMAT_DIMACS,
+    INPUT_FORMAT_MATRIX_MARKET
+} input_format_t;
+
+const char *const input_format_names[] = {"auto", "graph", "gbin", "edges", "dimacs", "mtx"};
+
+/**
+ * @brief Input reader, regular files are mapped to memory, other input is read in large blocks.
+ * Names are kept in place as (position, length) slices of data, unfinished name is moved
+ * to the beginning of the buffer before the next block is read.
+ */
+typedef struct reader
+{
+    const char *data;
+    size_t length;
+    size_t position;
+    // mapped file
+    void *mapping;
+    size_t mapping_length;
+    // read buffer
+    FILE *stream;
+    char *buffer;
+    // start of the first name that has to stay in data
+    size_t name_start;
+} reader_t;
+
+/**
+ * @brief Parser state of graph context, input position is reported as lines:columns.
+ */
+struct parser_state
+{
+    reader_t reader;
+    int lines;
+    int columns;
+    input_format_t input_format;
+    // scan of name characters supported by CPU
+    tokenizer_scan_t scan_name;
+};
+
+/**
+ * @brief Internal function returns parser state of bound graph context, state is created on the first use.
+ * @return parser_state_t* parser state
+ */
+parser_state_t *parser_get_state()
+{
+    graph_ctx_t *ctx = graph_ctx_current();
+    if (!ctx->parser)
+    {
+        ctx->parser = (parser_state_t *)alloc(1, sizeof(parser_state_t));
+        alloc_keep(ctx->parser);
+        ctx->parser->reader.name_start = NAME_NONE;
+        ctx->parser->input_format = INPUT_FORMAT_AUTO;
+    }
+    return ctx->parser;
+}
+
+/**
+ * @brief Set format of parsed input
+ * @param name format name (auto, graph, gbin, edges, dimacs or mtx)
+ * @return bool format name is known
+ */
+bool parser_set_format(const char *name)
+{
+    parser_state_t *parser = parser_get_state();
+    for (size_t i = 0; i < sizeof(input_format_names) / sizeof(input_format_names[0]); i++)
+    {
+        if (strcmp(name, input_format_names[i]) == 0)
+        {
+            parser->input_format = (input_format_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Function opens reader for stream, maps it to memory when it is a regular file.
+ * @param parser parser state
+ * @param stream data input stream
+ */
+void reader_open(parser_state_t *parser, FILE *stream)
+{
+    parser->reader = (reader_t){.stream = stream, .name_start = NAME_NONE};
+    parser->scan_name = tokenizer_select_scan();
+
+    int fd = fileno(stream);
+    struct stat stat_info;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (fd >= 0 && offset >= 0 && fstat(fd, &stat_info) == 0 && S_ISREG(stat_info.st_mode) && stat_info.st_size > offset)
+    {
+        void *mapping = mmap(NULL, (size_t)stat_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            posix_madvise(mapping, (size_t)stat_info.st_size, POSIX_MADV_SEQUENTIAL);
+            parser->reader.mapping = mapping;
+            parser->reader.mapping_length = (size_t)stat_info.st_size;
+            parser->reader.data = (const char *)mapping;
+            parser->reader.position = (size_t)offset;
+            parser->reader.length = parser->reader.mapping_length;
+            STATS_ADD(bytesParsedCounter, parser->reader.length - parser->reader.position);
+            return;
+        }
+    }
+
+    parser->reader.buffer = (char *)alloc(READ_BUFFER_SIZE, sizeof(char));
+    parser->reader.data = parser->reader.buffer;
+}
+
+/**
+ * @brief Function closes reader, unmaps file or frees read buffer.
+ * @param parser parser state
+ */
+void reader_close(parser_state_t *parser)
+{
+    if (parser->reader.mapping)
+    {
+        munmap(parser->reader.mapping, parser->reader.mapping_length);
+    }
+    alloc_free(parser->reader.buffer);
+    parser->reader = (reader_t){.name_start = NAME_NONE};
+}
+
+/**
+ * @brief Function reads next block of stream to read buffer, unfinished name is kept at the beginning of the buffer.
+ * @param parser parser state
+ * @return bool any data were read
+ */
+bool reader_refill(parser_state_t *parser)
+{
+    if (!parser->reader.buffer)
+    {
+        return false;
+    }
+
+    size_t keep_start = parser->reader.name_start != NAME_NONE ? parser->reader.name_start : parser->reader.length;
+    size_t keep_length = parser->reader.length - keep_start;
+    memmove(parser->reader.buffer, parser->reader.buffer + keep_start, keep_length);
+    if (parser->reader.name_start != NAME_NONE)
+    {
+        parser->reader.name_start = 0;
+    }
 
-FILE *stream_s;
+    size_t read_length = fread(parser->reader.buffer + keep_length, sizeof(char), READ_BUFFER_SIZE - keep_length, parser->reader.stream);
+    parser->reader.length = keep_length + read_length;
+    parser->reader.position = keep_length;
+    STATS_ADD(bytesParsedCounter, read_length);
+    return read_length > 0;
+}
 
-int lines = 1;
-int columns = 1;
+/**
+ * @brief Function returns next input character.
+ * @param parser parser state
+ * @return int character or EOF
+ */
+int reader_next(parser_state_t *parser)
+{
+    if (parser->reader.position == parser->reader.length && !reader_refill(parser))
+    {
+        return EOF;
+    }
+    return (unsigned char)parser->reader.data[parser->reader.position++];
+}
+
+/**
+ * @brief Function returns next input character without consuming it.
+ * @param parser parser state
+ * @return int character or EOF
+ */
+int reader_peek(parser_state_t *parser)
+{
+    if (parser->reader.position == parser->reader.length && !reader_refill(parser))
+    {
+        return EOF;
+    }
+    return (unsigned char)parser->reader.data[parser->reader.position];
+}
+
+/**
+ * @brief Function consumes the rest of the name started by the last read character.
+ * Name characters are scanned in blocks by the tokenizer, columns are moved to the last of them.
+ * @param parser parser state
+ * @param name_length current length of the name including the last read character
+ * @return size_t count of consumed characters
+ */
+size_t reader_scan_name(parser_state_t *parser, size_t name_length)
+{
+    size_t run_length = parser->scan_name(parser->reader.data + parser->reader.position, parser->reader.length - parser->reader.position);
+
+    // character after the maximal length is reported at its position
+    if (name_length + run_length > MAX_NODE_NAME_LENGTH)
+    {
+        parser->columns += (int)(MAX_NODE_NAME_LENGTH - name_length + 1);
+        error_exit(parserNodeNameLengthOverflowError, "Node name lenght overflow (max %i characters) at position %i:%i\n", MAX_NODE_NAME_LENGTH, parser->lines, parser->columns);
+    }
+
+    parser->reader.position += run_length;
+    parser->columns += (int)run_length;
+    return run_length;
+}
+
+/**
+ * @brief Function detects input format from its beginning, first block of unmapped input is read.
+ * Binary graph and Matrix Market are recognized by their banners, otherwise the first non blank
+ * character selects graph ('{'), DIMACS ('c' or 'p') or edge list (number or comment).
+ * @param parser parser state
+ * @return input_format_t detected format, graph format when nothing else matches
+ */
+input_format_t reader_detect_format(parser_state_t *parser)
+{
+    reader_peek(parser);
+    const char *data = parser->reader.data + parser->reader.position;
+    size_t length = parser->reader.length - parser->reader.position;
+
+    if (length >= GRAPH_BINARY_MAGIC_LENGTH && memcmp(data, GRAPH_BINARY_MAGIC, GRAPH_BINARY_MAGIC_LENGTH) == 0)
+    {
+        return INPUT_FORMAT_BINARY;
+    }
+    if (length >= strlen(MATRIX_MARKET_BANNER) && memcmp(data, MATRIX_MARKET_BANNER, strlen(MATRIX_MARKET_BANNER)) == 0)
+    {
+        return INPUT_FORMAT_MATRIX_MARKET;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        switch (data[i])
+        {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            continue;
+        case 'c':
+        case 'p':
+            return INPUT_FORMAT_DIMACS;
+        case '#':
+        case '%':
+            return INPUT_FORMAT_EDGE_LIST;
+        default:
+            return data[i] >= '0' && data[i] <= '9' ? INPUT_FORMAT_EDGE_LIST : INPUT_FORMAT_GRAPH;
+        }
+    }
+    return INPUT_FORMAT_GRAPH;
+}
+
+/**
+ * @brief Function loads binary graph from reader without parsing. Aligned mapped file is passed to graph as it is,
+ * other input is read whole to allocated memory. Graph takes ownership of the mapping or memory.
+ * @param parser parser state
+ */
+void parse_binary_data(parser_state_t *parser)
+{
+    const char *data = parser->reader.data + parser->reader.position;
+    size_t length = parser->reader.length - parser->reader.position;
+
+    if (parser->reader.mapping && (uintptr_t)data % sizeof(uint64_t) == 0)
+    {
+        // graph is traversed in random order, sequential read ahead does not help
+        posix_madvise(parser->reader.mapping, parser->reader.mapping_length, POSIX_MADV_NORMAL);
+        graph_load_binary(data, length, parser->reader.mapping, parser->reader.mapping_length, true);
+        parser->reader.mapping = NULL;
+        return;
+    }
+
+    size_t capacity = length > READ_BUFFER_SIZE ? length : READ_BUFFER_SIZE;
+    char *storage = (char *)alloc(capacity, sizeof(char));
+    memcpy(storage, data, length);
+    while (!parser->reader.mapping)
+    {
+        if (length == capacity)
+        {
+            capacity *= 2;
+            storage = (char *)alloc_resize(storage, capacity, sizeof(char));
+        }
+        size_t read_length = fread(storage + length, sizeof(char), capacity - length, parser->reader.stream);
+        if (read_length == 0)
+        {
+            break;
+        }
+        length += read_length;
+    }
+    graph_load_binary(storage, length, storage, capacity, false);
+}
 
 /**
  * @brief Function parse node data to graph structure
+ * @param parser parser state
  */
-void parse_node_data()
+void parse_node_data(parser_state_t *parser)
 {
 
     bool list_start = false;
     bool list_split = false;
     bool list_end = false;
 
-    char node_name[MAX_NODE_NAME_LENGTH + 1] = "\0";
+    size_t name_length = 0;
 
     while (!list_end)
     {
 
-        char last_char = fgetc(stream_s);
+        int last_char = reader_next(parser);
 
         switch (last_char)
         {
 
-        case -1:
+        case EOF:
             error_exit(parserSyntaxError, "Graph is not finished, unexpected 'EOF'\n");
             break;
 
         case '\n':
         case '\r':
-            if (strlen(node_name) != 0)
+            if (name_length != 0)
             {
-                error_exit(parserSyntaxError, "Unexpected 'EOL' at position %i:%i\n", lines, columns);
+                error_exit(parserSyntaxError, "Unexpected 'EOL' at position %i:%i\n", parser->lines, parser->columns);
             }
-            lines++;
-            columns = 0;
+            parser->lines++;
+            parser->columns = 0;
             break;
 
         case '{':
             if (list_start)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             list_start = true;
             break;
@@ -61,46 +369,48 @@ void parse_node_data()
         case '}':
             if (!list_start || list_split)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             list_end = true;
             break;
 
         case ',':
-            if (!list_start || strlen(node_name) == 0)
+            if (!list_start || name_length == 0)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             list_split = true;
             break;
 
         default:
-            if (!list_start || !((last_char >= 'a' && last_char <= 'z') || (last_char >= 'A' && last_char <= 'Z') || (last_char >= '0' && last_char <= '9')))
+            if (!list_start || !tokenizer_is_name_char(last_char))
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
 
             list_split = false;
 
-            if (strlen(node_name) == MAX_NODE_NAME_LENGTH)
+            if (name_length == MAX_NODE_NAME_LENGTH)
             {
-                error_exit(parserNodeNameLengthOverflowError, "Node name lenght overflow (max %i characters) at position %i:%i\n", MAX_NODE_NAME_LENGTH, lines, columns);
+                error_exit(parserNodeNameLengthOverflowError, "Node name lenght overflow (max %i characters) at position %i:%i\n", MAX_NODE_NAME_LENGTH, parser->lines, parser->columns);
             }
-            node_name[strlen(node_name)] = last_char;
+            if (name_length == 0)
+            {
+                parser->reader.name_start = parser->reader.position - 1;
+            }
+            name_length++;
+            name_length += reader_scan_name(parser, name_length);
             break;
         }
 
-        if ((last_char == ',' || last_char == '}') && strlen(node_name) != 0)
+        if ((last_char == ',' || last_char == '}') && name_length != 0)
         {
-            graph_create_node(node_name);
-            int node_name_len = (int)strlen(node_name);
-            for (int i = 0; i < node_name_len; i++)
-            {
-                node_name[i] = '\0';
-            }
+            graph_create_node(parser->reader.data + parser->reader.name_start, name_length);
+            parser->reader.name_start = NAME_NONE;
+            name_length = 0;
         }
 
-        columns++;
+        parser->columns++;
     }
 
     if (graph_get_node_count() == 0)
@@ -111,8 +421,9 @@ void parse_node_data()
 
 /**
  * @brief Function parse edge data to graph structure
+ * @param parser parser state
  */
-void parse_edge_data()
+void parse_edge_data(parser_state_t *parser)
 {
 
     bool list_start = false;
@@ -123,35 +434,37 @@ void parse_edge_data()
     bool edge_split = false;
     bool edge_end = false;
 
-    char node_name[MAX_NODE_NAME_LENGTH + 1] = "\0";
-    char node2_name[MAX_NODE_NAME_LENGTH + 1] = "\0";
+    // names are slices of reader data, second name starts at name_start + name2_offset
+    size_t name_length = 0;
+    size_t name2_offset = 0;
+    size_t name2_length = 0;
 
     while (!list_end)
     {
 
-        char last_char = fgetc(stream_s);
+        int last_char = reader_next(parser);
 
         switch (last_char)
         {
 
-        case -1:
+        case EOF:
             error_exit(parserSyntaxError, "Graph is not finished, unexpected 'EOF'\n");
             break;
 
         case '\n':
         case '\r':
-            if (strlen(node_name) != 0 || strlen(node2_name) != 0)
+            if (name_length != 0 || name2_length != 0)
             {
-                error_exit(parserSyntaxError, "Unexpected 'EOL' at position %i:%i\n", lines, columns);
+                error_exit(parserSyntaxError, "Unexpected 'EOL' at position %i:%i\n", parser->lines, parser->columns);
             }
-            lines++;
-            columns = 0;
+            parser->lines++;
+            parser->columns = 0;
             break;
 
         case '{':
             if (list_start)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             list_start = true;
             break;
@@ -159,7 +472,7 @@ void parse_edge_data()
         case '}':
             if (!list_start || edge_start)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             list_end = true;
             break;
@@ -167,24 +480,24 @@ void parse_edge_data()
         case '(':
             if (!list_start || edge_start || !list_split)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             edge_start = true;
             list_split = false;
             break;
 
         case ')':
-            if (!list_start || !edge_start || !edge_split || strlen(node2_name) == 0)
+            if (!list_start || !edge_start || !edge_split || name2_length == 0)
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             edge_end = true;
             break;
 
         case ',':
-            if (!list_start || edge_split || list_split || (edge_start && strlen(node_name) == 0))
+            if (!list_start || edge_split || list_split || (edge_start && name_length == 0))
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
             if (edge_start)
             {
@@ -197,60 +510,494 @@ void parse_edge_data()
             break;
 
         default:
-            if (!list_start || !edge_start || !((last_char >= 'a' && last_char <= 'z') || (last_char >= 'A' && last_char <= 'Z') || (last_char >= '0' && last_char <= '9')))
+            if (!list_start || !edge_start || !tokenizer_is_name_char(last_char))
             {
-                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, lines, columns);
+                error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
             }
 
-            if (strlen(node_name) == MAX_NODE_NAME_LENGTH || strlen(node2_name) == MAX_NODE_NAME_LENGTH)
+            if (name_length == MAX_NODE_NAME_LENGTH || name2_length == MAX_NODE_NAME_LENGTH)
             {
-                error_exit(parserNodeNameLengthOverflowError, "Node name lenght overflow (max %i characters) at position %i:%i\n", MAX_NODE_NAME_LENGTH, lines, columns);
+                error_exit(parserNodeNameLengthOverflowError, "Node name lenght overflow (max %i characters) at position %i:%i\n", MAX_NODE_NAME_LENGTH, parser->lines, parser->columns);
             }
 
             if (!edge_split)
             {
-                node_name[strlen(node_name)] = last_char;
+                if (name_length == 0)
+                {
+                    parser->reader.name_start = parser->reader.position - 1;
+                }
+                name_length++;
+                name_length += reader_scan_name(parser, name_length);
             }
             else
             {
-                node2_name[strlen(node2_name)] = last_char;
+                if (name2_length == 0)
+                {
+                    name2_offset = parser->reader.position - 1 - parser->reader.name_start;
+                }
+                name2_length++;
+                name2_length += reader_scan_name(parser, name2_length);
             }
             break;
         }
 
-        if (edge_end && strlen(node_name) != 0 && strlen(node2_name) != 0)
+        if (edge_end && name_length != 0 && name2_length != 0)
         {
-            graph_create_edge(node_name, node2_name);
-            int node_name_len = (int)strlen(node_name);
-            for (int i = 0; i < node_name_len; i++)
+            const char *name = parser->reader.data + parser->reader.name_start;
+            graph_create_edge(name, name_length, name + name2_offset, name2_length);
+            parser->reader.name_start = NAME_NONE;
+            name_length = 0;
+            name2_length = 0;
+            edge_start = false;
+            edge_split = false;
+            edge_end = false;
+        }
+
+        parser->columns++;
+    }
+}
+
+/**
+ * @brief Function reports unexpected character of line based format at current position.
+ * @param parser parser state
+ */
+void format_error_unexpected(parser_state_t *parser)
+{
+    int last_char = reader_peek(parser);
+    if (last_char == EOF)
+    {
+        error_exit(parserSyntaxError, "Unexpected 'EOF' at position %i:%i\n", parser->lines, parser->columns);
+    }
+    if (last_char == '\n' || last_char == '\r')
+    {
+        error_exit(parserSyntaxError, "Unexpected 'EOL' at position %i:%i\n", parser->lines, parser->columns);
+    }
+    error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
+}
+
+/**
+ * @brief Function skips spaces and tabs of line based format.
+ * @param parser parser state
+ */
+void format_skip_blanks(parser_state_t *parser)
+{
+    int last_char = reader_peek(parser);
+    while (last_char == ' ' || last_char == '\t')
+    {
+        parser->reader.position++;
+        parser->columns++;
+        last_char = reader_peek(parser);
+    }
+}
+
+/**
+ * @brief Function skips the rest of the current line including its end.
+ * @param parser parser state
+ */
+void format_skip_line(parser_state_t *parser)
+{
+    int last_char = reader_next(parser);
+    while (last_char != '\n' && last_char != EOF)
+    {
+        last_char = reader_next(parser);
+    }
+    parser->lines++;
+    parser->columns = 1;
+}
+
+/**
+ * @brief Function checks that only blanks remain on the current line and skips them.
+ * @throw Error when line contains anything else.
+ * @param parser parser state
+ */
+void format_end_line(parser_state_t *parser)
+{
+    format_skip_blanks(parser);
+    int last_char = reader_peek(parser);
+    if (last_char == '\r')
+    {
+        parser->reader.position++;
+        last_char = reader_peek(parser);
+    }
+    if (last_char != '\n' && last_char != EOF)
+    {
+        format_error_unexpected(parser);
+    }
+    format_skip_line(parser);
+}
+
+/**
+ * @brief Function reads unsigned decimal number of line based format, leading blanks are skipped.
+ * @throw Error when number does not fit 32 bits.
+ * @param parser parser state
+ * @param value pointer where read number is stored
+ * @return bool number was read
+ */
+bool format_read_number(parser_state_t *parser, uint64_t *value)
+{
+    format_skip_blanks(parser);
+    int last_char = reader_peek(parser);
+    if (last_char < '0' || last_char > '9')
+    {
+        return false;
+    }
+
+    uint64_t number = 0;
+    while (last_char >= '0' && last_char <= '9')
+    {
+        number = number * 10 + (uint64_t)(last_char - '0');
+        if (number > UINT32_MAX)
+        {
+            error_exit(parserNodeCountOverflowError, "Number is too large at position %i:%i\n", parser->lines, parser->columns);
+        }
+        parser->reader.position++;
+        parser->columns++;
+        last_char = reader_peek(parser);
+    }
+    *value = number;
+    return true;
+}
+
+/**
+ * @brief Function reads keyword of line based format converted to lower case, leading blanks are skipped.
+ * @param parser parser state
+ * @param keyword buffer of MAX_KEYWORD_LENGTH + 1 characters for the keyword
+ * @return bool keyword was read
+ */
+bool format_read_keyword(parser_state_t *parser, char *keyword)
+{
+    format_skip_blanks(parser);
+    size_t length = 0;
+    int last_char = reader_peek(parser);
+    while (length < MAX_KEYWORD_LENGTH && ((last_char >= 'a' && last_char <= 'z') || (last_char >= 'A' && last_char <= 'Z') || last_char == '-'))
+    {
+        keyword[length++] = (char)(last_char >= 'A' && last_char <= 'Z' ? last_char - 'A' + 'a' : last_char);
+        parser->reader.position++;
+        parser->columns++;
+        last_char = reader_peek(parser);
+    }
+    keyword[length] = '\0';
+    return length != 0;
+}
+
+/**
+ * @brief Function reads required number of line based format.
+ * @throw Error when there is no number at current position.
+ * @param parser parser state
+ * @return uint64_t read number
+ */
+uint64_t format_expect_number(parser_state_t *parser)
+{
+    uint64_t value = 0;
+    if (!format_read_number(parser, &value))
+    {
+        format_error_unexpected(parser);
+    }
+    return value;
+}
+
+/**
+ * @brief Function creates edge between numbered nodes, numbers are checked against node count.
+ * @param parser parser state
+ * @param number first node number
+ * @param number2 second node number
+ * @param firstNumber number of the first node
+ */
+void format_create_edge(parser_state_t *parser, uint64_t number, uint64_t number2, unsigned int firstNumber)
+{
+    uint64_t node_count = graph_get_node_count();
+    if (number < firstNumber || number2 < firstNumber || number - firstNumber >= node_count || number2 - firstNumber >= node_count)
+    {
+        error_exit(graphNodeNotFoundError, "Node number out of range (%u to %" PRIu64 ") at line %i\n", firstNumber, node_count + firstNumber - 1, parser->lines);
+    }
+    graph_create_edge_by_index((uint32_t)(number - firstNumber), (uint32_t)(number2 - firstNumber));
+}
+
+/**
+ * @brief Function reads node number of edge list, number can exceed nodes of already read edges
+ * by at most EDGE_LIST_MAX_NUMBER_GAP.
+ * @throw Error when there is no number at current position or number is too large.
+ * @param parser parser state
+ * @param edgeCount count of already read edges
+ * @return uint64_t read number
+ */
+uint64_t format_expect_edge_list_number(parser_state_t *parser, uint64_t edgeCount)
+{
+    format_skip_blanks(parser);
+    int columns = parser->columns;
+    uint64_t value = format_expect_number(parser);
+    if (value >= edgeCount * 2 + EDGE_LIST_MAX_NUMBER_GAP)
+    {
+        error_exit(parserNodeCountOverflowError, "Node number %" PRIu64 " is too large for %" PRIu64 " edges read before it at position %i:%i\n",
+                   value, edgeCount, parser->lines, columns);
+    }
+    return value;
+}
+
+/**
+ * @brief Function parse whitespace separated edge list "u v" to numbered graph, node numbers start at 0
+ * and graph has (largest number + 1) nodes. Lines starting with '#' or '%' are comments,
+ * further columns (e.g. weights) are ignored. Node numbers have to be dense, number can exceed
+ * twice the count of edges read before it by at most EDGE_LIST_MAX_NUMBER_GAP.
+ * @param parser parser state
+ */
+void parse_edge_list_data(parser_state_t *parser)
+{
+    uint64_t edge_count = 0;
+    while (true)
+    {
+        format_skip_blanks(parser);
+        int last_char = reader_peek(parser);
+        if (last_char == EOF)
+        {
+            break;
+        }
+        if (last_char == '#' || last_char == '%' || last_char == '\n' || last_char == '\r')
+        {
+            format_skip_line(parser);
+            continue;
+        }
+
+        uint64_t number = format_expect_edge_list_number(parser, edge_count);
+        if (reader_peek(parser) != ' ' && reader_peek(parser) != '\t')
+        {
+            format_error_unexpected(parser);
+        }
+        uint64_t number2 = format_expect_edge_list_number(parser, edge_count);
+        graph_create_numbered_nodes((number > number2 ? number : number2) + 1, 0);
+        format_create_edge(parser, number, number2, 0);
+        format_skip_line(parser);
+        edge_count++;
+    }
+
+    if (graph_get_node_count() == 0)
+    {
+        error_exit(parserNodeCountZeroError, "Graph node list is empty\n");
+    }
+}
+
+/**
+ * @brief Function parse DIMACS graph ("p edge n m" problem line and "e u v" edge lines) to numbered graph,
+ * node numbers start at 1. Lines starting with 'c' are comments.
+ * @param parser parser state
+ */
+void parse_dimacs_data(parser_state_t *parser)
+{
+    bool problem = false;
+    char keyword[MAX_KEYWORD_LENGTH + 1];
+
+    while (true)
+    {
+        format_skip_blanks(parser);
+        int last_char = reader_peek(parser);
+        if (last_char == EOF)
+        {
+            break;
+        }
+        if (last_char == 'c' || last_char == '\n' || last_char == '\r')
+        {
+            format_skip_line(parser);
+            continue;
+        }
+
+        parser->reader.position++;
+        parser->columns++;
+        if (last_char == 'p' && !problem)
+        {
+            if (!format_read_keyword(parser, keyword) || (strcmp(keyword, "edge") != 0 && strcmp(keyword, "col") != 0))
             {
-                node_name[i] = '\0';
+                error_exit(parserSyntaxError, "DIMACS problem must be 'edge' or 'col' at line %i\n", parser->lines);
             }
-            int node2_name_len = (int)strlen(node2_name);
-            for (int i = 0; i < node2_name_len; i++)
+            uint64_t node_count = format_expect_number(parser);
+            format_expect_number(parser);
+            format_end_line(parser);
+            if (node_count == 0)
             {
-                node2_name[i] = '\0';
+                error_exit(parserNodeCountZeroError, "Graph node list is empty\n");
             }
-            edge_start = false;
-            edge_split = false;
-            edge_end = false;
+            graph_create_numbered_nodes(node_count, 1);
+            problem = true;
         }
+        else if (last_char == 'e' && problem)
+        {
+            uint64_t number = format_expect_number(parser);
+            uint64_t number2 = format_expect_number(parser);
+            format_create_edge(parser, number, number2, 1);
+            format_end_line(parser);
+        }
+        else
+        {
+            parser->columns--;
+            error_exit(parserSyntaxError, "Unexpected '%c' at position %i:%i\n", last_char, parser->lines, parser->columns);
+        }
+    }
 
-        columns++;
+    if (!problem)
+    {
+        error_exit(parserSyntaxError, "DIMACS problem line is missing\n");
     }
 }
 
 /**
- * @brief Function reads data from stream and parse them to graph sctructure
+ * @brief Function parse Matrix Market coordinate matrix to numbered graph, every off diagonal entry (i, j)
+ * is an edge, node numbers start at 1 and graph has max(rows, columns) nodes. Entry values are ignored.
+ * General matrix of unoriented graph has both (i, j) and (j, i), so the second one is not reported as duplicate edge.
+ * @param parser parser state
+ */
+void parse_matrix_market_data(parser_state_t *parser)
+{
+    char keyword[MAX_KEYWORD_LENGTH + 1];
+
+    parser->reader.position += strlen(MATRIX_MARKET_BANNER);
+    parser->columns += (int)strlen(MATRIX_MARKET_BANNER);
+    if (!format_read_keyword(parser, keyword) || strcmp(keyword, "matrix") != 0 || !format_read_keyword(parser, keyword) || strcmp(keyword, "coordinate") != 0)
+    {
+        error_exit(parserSyntaxError, "Only Matrix Market coordinate matrix is supported\n");
+    }
+    // field keyword is followed by symmetry keyword, symmetric matrices store only one triangle
+    bool general = format_read_keyword(parser, keyword) && format_read_keyword(parser, keyword) && strcmp(keyword, "general") == 0;
+    format_skip_line(parser);
+
+    // size line follows comments
+    while (reader_peek(parser) == '%')
+    {
+        format_skip_line(parser);
+    }
+    uint64_t row_count = format_expect_number(parser);
+    uint64_t column_count = format_expect_number(parser);
+    uint64_t entry_count = format_expect_number(parser);
+    format_end_line(parser);
+    uint64_t node_count = row_count > column_count ? row_count : column_count;
+    if (node_count == 0)
+    {
+        error_exit(parserNodeCountZeroError, "Graph node list is empty\n");
+    }
+    graph_create_numbered_nodes(node_count, 1);
+    if (general && !graph_is_streaming())
+    {
+        graph_set_mirrored_edges();
+    }
+
+    uint64_t entries = 0;
+    while (true)
+    {
+        format_skip_blanks(parser);
+        int last_char = reader_peek(parser);
+        if (last_char == EOF)
+        {
+            break;
+        }
+        if (last_char == '%' || last_char == '\n' || last_char == '\r')
+        {
+            format_skip_line(parser);
+            continue;
+        }
+
+        uint64_t row = format_expect_number(parser);
+        uint64_t column = format_expect_number(parser);
+        if (row == 0 || column == 0 || row > row_count || column > column_count)
+        {
+            error_exit(graphNodeNotFoundError, "Matrix entry (%" PRIu64 ",%" PRIu64 ") out of range at line %i\n", row, column, parser->lines);
+        }
+        format_skip_line(parser);
+        entries++;
+        // diagonal entries are matrix values, not loops
+        if (row != column)
+        {
+            format_create_edge(parser, row, column, 1);
+        }
+    }
+
+    if (entries != entry_count)
+    {
+        error_exit(parserSyntaxError, "Matrix Market file has %" PRIu64 " entries, expected %" PRIu64 "\n", entries, entry_count);
+    }
+}
+
+/**
+ * @brief Function parse input in selected or detected format to initialized graph and finalizes it
+ * @param parser parser state
+ * @param stream data input stream
+ */
+void parse_input(parser_state_t *parser, FILE *stream)
+{
+    parser->lines = 1;
+    parser->columns = 1;
+    reader_open(parser, stream);
+
+    input_format_t format = parser->input_format != INPUT_FORMAT_AUTO ? parser->input_format : reader_detect_format(parser);
+    switch (format)
+    {
+    case INPUT_FORMAT_BINARY:
+        if (graph_is_streaming())
+        {
+            error_exit(parserBinaryFormatError, "Binary graph can not be read in streaming mode\n");
+        }
+        parse_binary_data(parser);
+        break;
+    case INPUT_FORMAT_EDGE_LIST:
+        parse_edge_list_data(parser);
+        break;
+    case INPUT_FORMAT_DIMACS:
+        parse_dimacs_data(parser);
+        break;
+    case INPUT_FORMAT_MATRIX_MARKET:
+        parse_matrix_market_data(parser);
+        break;
+    default:
+        parse_node_data(parser);
+        parse_edge_data(parser);
+        break;
+    }
+
+    reader_close(parser);
+
+    graph_finalize();
+}
+
+/**
+ * @brief Function reads data from stream and parse them to graph sctructure,
+ * binary graph is loaded without parsing
  * @param stream data input stream
  */
 void parse_data(FILE *stream)
 {
     graph_init();
 
-    stream_s = stream;
+    parse_input(parser_get_state(), stream);
+}
+
+/**
+ * @brief Function reads data from stream and parse them to streaming graph sctructure,
+ * edges are merged into connected components as they are read and not stored
+ * @param stream data input stream
+ */
+void parse_data_streaming(FILE *stream)
+{
+    graph_init_streaming();
+
+    parse_input(parser_get_state(), stream);
+}
 
-    parse_node_data();
+/**
+ * @brief Function closes input of interrupted parsing, parser settings are kept
+ */
+void parser_release()
+{
+    graph_ctx_t *ctx = graph_ctx_current();
+    if (ctx->parser)
+    {
+        reader_close(ctx->parser);
+    }
+}
 
-    parse_edge_data();
+/**
+ * @brief Function destroys parser state of bound graph context
+ */
+void parser_destroy()
+{
+    graph_ctx_t *ctx = graph_ctx_current();
+    parser_release();
+    alloc_free(ctx->parser);
+    ctx->parser = NULL;
 }
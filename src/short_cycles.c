@@ -0,0 +1,441 @@
+/**
+ * @file short_cycles.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for counting short simple cycles of graph,
+ * vertices are ordered by degree and every cycle is counted from its highest (triangles from lowest) vertex,
+ * triangles by sorted neighbor list (or adjacency matrix row) intersections, 4-cycles by wedge counting
+ * and longer cycles by depth bounded search
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../include/short_cycles.h"
+#include "../include/thread_pool.h"
+#include "../include/bitset.h"
+
+/**
+ * @brief Context of short cycle counting shared by all tasks.
+ * Vertices are renumbered by rank in (degree, index) order, neighbor lists are sorted by rank,
+ * so neighbors of lower rank are a prefix and neighbors of higher rank a suffix of every list.
+ */
+typedef struct short_cycles
+{
+	uint32_t node_count;
+	uint32_t max_length;
+	// vertex of graph with given rank
+	uint32_t *vertices;
+	uint64_t *offsets;
+	uint32_t *neighbors;
+	// triangles are counted by adjacency matrix rows of dense graph
+	bool dense;
+	// per worker state
+	uint64_t **length_counts;
+	uint64_t **directed_counts;
+	uint32_t **wedge_counts;
+	uint32_t **touched;
+	bool **closing;
+	bool **on_path;
+	uint32_t **path_marks;
+} short_cycles_t;
+
+/**
+ * @brief Count of elements of sorted list with value greater than bound, they are at the end of the list.
+ * @param list sorted list
+ * @param count list length
+ * @param bound lower bound (exclusive)
+ * @return uint32_t index of the first element greater than bound
+ */
+uint32_t sorted_upper_bound(const uint32_t *list, uint32_t count, uint32_t bound)
+{
+	uint32_t low = 0;
+	uint32_t high = count;
+	while (low < high)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		if (list[middle] <= bound)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @brief Count of common elements of 2 sorted lists, merged without branches on comparison result.
+ * @param list first sorted list
+ * @param count first list length
+ * @param list2 second sorted list
+ * @param count2 second list length
+ * @return uint64_t size of intersection
+ */
+uint64_t sorted_intersection_count(const uint32_t *list, uint32_t count, const uint32_t *list2, uint32_t count2)
+{
+	uint64_t common = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	while (i < count && j < count2)
+	{
+		uint32_t a = list[i];
+		uint32_t b = list2[j];
+		common += a == b;
+		i += a <= b;
+		j += b <= a;
+	}
+	return common;
+}
+
+/**
+ * @brief Count triangles with lowest index vertex of dense graph, for every higher neighbor b of vertex
+ * the adjacency matrix rows of both are intersected above b.
+ * @param a vertex index
+ * @return uint64_t count of triangles (a, b, c), a < b < c
+ */
+uint64_t dense_triangles(uint32_t a)
+{
+	vertex_span_t neighbors = graph_get_vertex_neighbors(a);
+	const uint64_t *row = graph_get_vertex_row(a);
+	size_t word_count = graph_get_matrix_row_word_count();
+	uint64_t triangles = 0;
+
+	for (uint32_t i = 0; i < neighbors.count; i++)
+	{
+		uint32_t b = neighbors.ids[i];
+		if (b < a)
+		{
+			continue;
+		}
+		const uint64_t *row2 = graph_get_vertex_row(b);
+		size_t word = b / BITSET_WORD_BITS;
+		uint64_t above_mask = (~(uint64_t)0 << (b % BITSET_WORD_BITS)) << 1;
+		triangles += (uint64_t)__builtin_popcountll(row[word] & row2[word] & above_mask);
+		triangles += bitset_and_count(row + word + 1, row2 + word + 1, word_count - word - 1);
+	}
+	return triangles;
+}
+
+/**
+ * @brief Count triangles with lowest rank vertex v, higher rank neighbors of v are intersected
+ * with higher rank neighbors of each of them. Degree order keeps the intersected lists short.
+ * @param cycles short cycle counting context
+ * @param v vertex rank
+ * @return uint64_t count of triangles
+ */
+uint64_t sparse_triangles(const short_cycles_t *cycles, uint32_t v)
+{
+	const uint32_t *list = &cycles->neighbors[cycles->offsets[v]];
+	uint32_t count = (uint32_t)(cycles->offsets[v + 1] - cycles->offsets[v]);
+	uint64_t triangles = 0;
+
+	for (uint32_t i = sorted_upper_bound(list, count, v); i < count; i++)
+	{
+		uint32_t u = list[i];
+		const uint32_t *list2 = &cycles->neighbors[cycles->offsets[u]];
+		uint32_t count2 = (uint32_t)(cycles->offsets[u + 1] - cycles->offsets[u]);
+		uint32_t higher2 = sorted_upper_bound(list2, count2, u);
+		triangles += sorted_intersection_count(&list[i + 1], count - i - 1, &list2[higher2], count2 - higher2);
+	}
+	return triangles;
+}
+
+/**
+ * @brief Count paths v-u-w with u and w of lower rank than v for every w, u is a closing vertex
+ * (lower rank neighbor of v), so wedge_counts[w] is count of closing neighbors of w.
+ * Counts of touched vertices are left set, they are used by 4-cycle counting and search.
+ * @param cycles short cycle counting context
+ * @param worker_index index of the worker
+ * @param v vertex rank
+ * @return uint32_t count of touched vertices
+ */
+uint32_t short_cycles_wedges(const short_cycles_t *cycles, unsigned int worker_index, uint32_t v)
+{
+	uint32_t *wedge_counts = cycles->wedge_counts[worker_index];
+	uint32_t *touched = cycles->touched[worker_index];
+	uint32_t touched_count = 0;
+
+	for (uint64_t i = cycles->offsets[v]; i < cycles->offsets[v + 1] && cycles->neighbors[i] < v; i++)
+	{
+		uint32_t u = cycles->neighbors[i];
+		for (uint64_t j = cycles->offsets[u]; j < cycles->offsets[u + 1] && cycles->neighbors[j] < v; j++)
+		{
+			uint32_t w = cycles->neighbors[j];
+			if (wedge_counts[w]++ == 0)
+			{
+				touched[touched_count++] = w;
+			}
+		}
+	}
+	return touched_count;
+}
+
+/**
+ * @brief Count 4-cycles with highest rank vertex v, each pair of wedges v-u-w with the same w
+ * closes one 4-cycle with opposite vertices v and w.
+ * @param cycles short cycle counting context
+ * @param worker_index index of the worker
+ * @param touched_count count of vertices touched by wedges of v
+ * @return uint64_t count of 4-cycles
+ */
+uint64_t short_cycles_squares(const short_cycles_t *cycles, unsigned int worker_index, uint32_t touched_count)
+{
+	const uint32_t *wedge_counts = cycles->wedge_counts[worker_index];
+	const uint32_t *touched = cycles->touched[worker_index];
+	uint64_t squares = 0;
+
+	for (uint32_t i = 0; i < touched_count; i++)
+	{
+		uint64_t wedges = wedge_counts[touched[i]];
+		squares += wedges * (wedges - 1) / 2;
+	}
+	return squares;
+}
+
+/**
+ * @brief Mark or unmark neighbors of closing path vertex at given path position, so the last search step
+ * can exclude closing vertices on path from wedge counts without adjacency lookups.
+ * @param cycles short cycle counting context
+ * @param worker_index index of the worker
+ * @param vertex closing path vertex
+ * @param position position of vertex in path
+ */
+void short_cycles_toggle_marks(const short_cycles_t *cycles, unsigned int worker_index, uint32_t vertex, uint32_t position)
+{
+	uint32_t *path_marks = cycles->path_marks[worker_index];
+	for (uint64_t i = cycles->offsets[vertex]; i < cycles->offsets[vertex + 1]; i++)
+	{
+		path_marks[cycles->neighbors[i]] ^= (uint32_t)1 << position;
+	}
+}
+
+/**
+ * @brief Depth bounded search of paths from start vertex through vertices of lower rank,
+ * path ending in closing vertex (lower rank neighbor of start) closes a cycle. Cycles of maximal length
+ * are counted without searching their last 2 vertices, the last vertex is a closing neighbor of the last
+ * searched vertex, they are counted by wedge counts without those already on path (marked neighbors
+ * of closing path vertices).
+ * Every cycle is found once in each direction. Depth is at most max_length, so recursion stays shallow.
+ * @param cycles short cycle counting context
+ * @param worker_index index of the worker
+ * @param start start vertex rank
+ * @param vertex last vertex of path
+ * @param path_length count of vertices of path
+ */
+void short_cycles_search(const short_cycles_t *cycles, unsigned int worker_index, uint32_t start, uint32_t vertex, uint32_t path_length)
+{
+	uint64_t *directed_counts = cycles->directed_counts[worker_index];
+	const bool *closing = cycles->closing[worker_index];
+	bool *on_path = cycles->on_path[worker_index];
+	if (path_length >= 5 && closing[vertex])
+	{
+		directed_counts[path_length]++;
+	}
+
+	on_path[vertex] = true;
+	if (closing[vertex])
+	{
+		short_cycles_toggle_marks(cycles, worker_index, vertex, path_length - 1);
+	}
+	if (path_length + 2 == cycles->max_length)
+	{
+		// the last path vertex is not searched, cycles through it are counted directly
+		const uint32_t *wedge_counts = cycles->wedge_counts[worker_index];
+		const uint32_t *path_marks = cycles->path_marks[worker_index];
+		for (uint64_t i = cycles->offsets[vertex]; i < cycles->offsets[vertex + 1] && cycles->neighbors[i] < start; i++)
+		{
+			uint32_t next = cycles->neighbors[i];
+			if (!on_path[next])
+			{
+				directed_counts[path_length + 1] += path_length + 1 >= 5 && closing[next];
+				directed_counts[path_length + 2] += wedge_counts[next] - (uint64_t)__builtin_popcount(path_marks[next]);
+			}
+		}
+	}
+	else
+	{
+		for (uint64_t i = cycles->offsets[vertex]; i < cycles->offsets[vertex + 1] && cycles->neighbors[i] < start; i++)
+		{
+			uint32_t next = cycles->neighbors[i];
+			if (!on_path[next])
+			{
+				short_cycles_search(cycles, worker_index, start, next, path_length + 1);
+			}
+		}
+	}
+	if (closing[vertex])
+	{
+		short_cycles_toggle_marks(cycles, worker_index, vertex, path_length - 1);
+	}
+	on_path[vertex] = false;
+}
+
+/**
+ * @brief Thread pool task, counts short cycles of vertex given by task index. Triangles are counted
+ * from their lowest rank vertex, longer cycles from their highest rank vertex.
+ * @param context short cycle counting context
+ * @param worker_index index of the worker
+ * @param task_index vertex rank
+ */
+void short_cycles_task(void *context, unsigned int worker_index, uint64_t task_index)
+{
+	short_cycles_t *cycles = (short_cycles_t *)context;
+	uint32_t v = (uint32_t)task_index;
+	uint64_t *length_counts = cycles->length_counts[worker_index];
+
+	length_counts[3] += cycles->dense ? dense_triangles(cycles->vertices[v]) : sparse_triangles(cycles, v);
+	if (cycles->max_length < 4)
+	{
+		return;
+	}
+
+	uint32_t touched_count = short_cycles_wedges(cycles, worker_index, v);
+	length_counts[4] += short_cycles_squares(cycles, worker_index, touched_count);
+	if (cycles->max_length >= 5)
+	{
+		bool *closing = cycles->closing[worker_index];
+		for (uint64_t i = cycles->offsets[v]; i < cycles->offsets[v + 1] && cycles->neighbors[i] < v; i++)
+		{
+			closing[cycles->neighbors[i]] = true;
+		}
+		short_cycles_search(cycles, worker_index, v, v, 1);
+		for (uint64_t i = cycles->offsets[v]; i < cycles->offsets[v + 1] && cycles->neighbors[i] < v; i++)
+		{
+			closing[cycles->neighbors[i]] = false;
+		}
+	}
+
+	uint32_t *wedge_counts = cycles->wedge_counts[worker_index];
+	const uint32_t *touched = cycles->touched[worker_index];
+	for (uint32_t i = 0; i < touched_count; i++)
+	{
+		wedge_counts[touched[i]] = 0;
+	}
+}
+
+/**
+ * @brief Renumber vertices by rank in (degree, index) order with counting sort and build neighbor lists
+ * of ranks. Vertices are visited in rank order and appended to lists of their neighbors, so every list is sorted.
+ * @param cycles short cycle counting context
+ */
+void short_cycles_rank(short_cycles_t *cycles)
+{
+	uint32_t node_count = cycles->node_count;
+	uint32_t max_degree = 0;
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		uint32_t degree = graph_get_vertex_degree(i);
+		max_degree = degree > max_degree ? degree : max_degree;
+	}
+
+	uint32_t *degree_offsets = (uint32_t *)alloc((size_t)max_degree + 2, sizeof(uint32_t));
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		degree_offsets[graph_get_vertex_degree(i) + 1]++;
+	}
+	for (uint32_t degree = 0; degree <= max_degree; degree++)
+	{
+		degree_offsets[degree + 1] += degree_offsets[degree];
+	}
+	uint32_t *ranks = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	cycles->vertices = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		ranks[i] = degree_offsets[graph_get_vertex_degree(i)]++;
+		cycles->vertices[ranks[i]] = i;
+	}
+	alloc_free(degree_offsets);
+
+	cycles->offsets = (uint64_t *)alloc((size_t)node_count + 1, sizeof(uint64_t));
+	for (uint32_t r = 0; r < node_count; r++)
+	{
+		cycles->offsets[r + 1] = cycles->offsets[r] + graph_get_vertex_degree(cycles->vertices[r]);
+	}
+	uint64_t arc_count = cycles->offsets[node_count];
+	cycles->neighbors = (uint32_t *)alloc(arc_count ? arc_count : 1, sizeof(uint32_t));
+	uint64_t *fill_offsets = (uint64_t *)alloc((size_t)node_count + 1, sizeof(uint64_t));
+	memcpy(fill_offsets, cycles->offsets, ((size_t)node_count + 1) * sizeof(uint64_t));
+	for (uint32_t r = 0; r < node_count; r++)
+	{
+		vertex_span_t neighbors = graph_get_vertex_neighbors(cycles->vertices[r]);
+		for (uint32_t i = 0; i < neighbors.count; i++)
+		{
+			uint32_t u = ranks[neighbors.ids[i]];
+			cycles->neighbors[fill_offsets[u]++] = r;
+		}
+	}
+	alloc_free(fill_offsets);
+	alloc_free(ranks);
+}
+
+/**
+ * @brief Count simple cycles of length 3 to max_length. Cycles of length at most 4 are counted by kernels
+ * in O(|E| * sqrt(|E|)) time (or O(|E| * |V| / 64) with adjacency matrix of dense graph), longer cycles
+ * by depth bounded search in O(|V| * D^(max_length - 2)), D = maximum degree.
+ * Vertices are independent tasks, they are processed in parallel by thread_count workers.
+ * @param max_length maximal cycle length, at least 3
+ * @param thread_count count of worker threads
+ * @param counts cycle counts initialized for max_length, cycles are added to it
+ */
+void short_cycles_count(uint32_t max_length, unsigned int thread_count, cycle_counts_t *counts)
+{
+	short_cycles_t cycles = {
+		.node_count = graph_get_node_count(),
+		.max_length = max_length,
+		.dense = graph_has_adjacency_matrix(),
+	};
+	short_cycles_rank(&cycles);
+
+	uint32_t node_count = cycles.node_count;
+	unsigned int worker_count = thread_count < node_count ? thread_count : node_count;
+	cycles.length_counts = (uint64_t **)alloc(worker_count, sizeof(uint64_t *));
+	cycles.directed_counts = (uint64_t **)alloc(worker_count, sizeof(uint64_t *));
+	cycles.wedge_counts = (uint32_t **)alloc(worker_count, sizeof(uint32_t *));
+	cycles.touched = (uint32_t **)alloc(worker_count, sizeof(uint32_t *));
+	cycles.closing = (bool **)alloc(worker_count, sizeof(bool *));
+	cycles.on_path = (bool **)alloc(worker_count, sizeof(bool *));
+	cycles.path_marks = (uint32_t **)alloc(worker_count, sizeof(uint32_t *));
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		cycles.length_counts[i] = (uint64_t *)alloc((size_t)max_length + 1, sizeof(uint64_t));
+		cycles.directed_counts[i] = (uint64_t *)alloc((size_t)max_length + 1, sizeof(uint64_t));
+		cycles.wedge_counts[i] = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+		cycles.touched[i] = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+		cycles.closing[i] = (bool *)alloc(node_count, sizeof(bool));
+		cycles.on_path[i] = (bool *)alloc(node_count, sizeof(bool));
+		cycles.path_marks[i] = (uint32_t *)alloc(node_count, sizeof(uint32_t));
+	}
+
+	thread_pool_run(worker_count, node_count, short_cycles_task, &cycles);
+
+	for (unsigned int i = 0; i < worker_count; i++)
+	{
+		for (uint32_t length = SHORT_CYCLE_MIN_LENGTH; length <= max_length && length <= counts->max_length; length++)
+		{
+			counts->by_length[length] += cycles.length_counts[i][length];
+			counts->total += cycles.length_counts[i][length];
+		}
+		cycle_counts_add_directed(counts, cycles.directed_counts[i], max_length);
+		alloc_free(cycles.length_counts[i]);
+		alloc_free(cycles.directed_counts[i]);
+		alloc_free(cycles.wedge_counts[i]);
+		alloc_free(cycles.touched[i]);
+		alloc_free(cycles.closing[i]);
+		alloc_free(cycles.on_path[i]);
+		alloc_free(cycles.path_marks[i]);
+	}
+	alloc_free(cycles.length_counts);
+	alloc_free(cycles.directed_counts);
+	alloc_free(cycles.wedge_counts);
+	alloc_free(cycles.touched);
+	alloc_free(cycles.closing);
+	alloc_free(cycles.on_path);
+	alloc_free(cycles.path_marks);
+	alloc_free(cycles.vertices);
+	alloc_free(cycles.offsets);
+	alloc_free(cycles.neighbors);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file stats.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for counters of operations in hot paths,
+ * every thread counts to its own counters without synchronization and adds them to its graph context
+ * when its work is done
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <pthread.h>
+#include <inttypes.h>
+#include "../include/stats.h"
+#include "../include/graph_ctx.h"
+
+#ifdef GRAPH_STATS
+_Thread_local stats_t stats_local;
+_Thread_local uint64_t stats_depth = 0;
+
+// counters of context may be flushed by more workers at once
+pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// names of counters in printed statistics
+const char *stats_counter_names[statsCounterCount] = {
+    "vertex visits",
+    "edge relaxations",
+    "max depth",
+    "name comparisons",
+    "bytes parsed",
+};
+
+/**
+ * @brief Function returns if counters were compiled in.
+ * @return bool counters are counted
+ */
+bool stats_available()
+{
+#ifdef GRAPH_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Function adds counters of calling thread to its bound graph context and clears them,
+ * called by every worker when its tasks are done.
+ */
+void stats_flush()
+{
+#ifdef GRAPH_STATS
+    stats_t *stats = &graph_ctx_current()->stats;
+    pthread_mutex_lock(&stats_lock);
+    for (int i = 0; i < statsCounterCount; i++)
+    {
+        if (i == maxDepthCounter)
+        {
+            if (stats->counters[i] < stats_local.counters[i])
+            {
+                stats->counters[i] = stats_local.counters[i];
+            }
+        }
+        else
+        {
+            stats->counters[i] += stats_local.counters[i];
+        }
+    }
+    pthread_mutex_unlock(&stats_lock);
+    stats_local = (stats_t){0};
+#endif
+}
+
+/**
+ * @brief Function moves counters counted since the last call from bound graph context to stats.
+ * @param stats stats structure pointer
+ */
+void stats_take(stats_t *stats)
+{
+    stats_flush();
+    graph_ctx_t *ctx = graph_ctx_current();
+    *stats = ctx->stats;
+    ctx->stats = (stats_t){0};
+}
+
+/**
+ * @brief Function prints non zero counters on one line.
+ * @param stats stats structure pointer
+ * @param output output stream
+ */
+void stats_print(const stats_t *stats, FILE *output)
+{
+    bool first = true;
+    fprintf(output, "  stats:");
+    for (int i = 0; i < statsCounterCount; i++)
+    {
+        if (stats->counters[i] != 0)
+        {
+            fprintf(output, "%s %s %" PRIu64, first ? "" : ",", stats_counter_names[i], stats->counters[i]);
+            first = false;
+        }
+    }
+    fprintf(output, "%s\n", first ? " none" : "");
+}
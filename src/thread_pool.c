@@ -0,0 +1,223 @@
+/**
+ * @file thread_pool.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for parallel execution of independent tasks
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <unistd.h>
+#include "../include/thread_pool.h"
+#include "../include/graph.h"
+#include "../include/graph_ctx.h"
+#include "../include/stats.h"
+
+/**
+ * Every worker owns a range of task indexes. Owner takes tasks from the beginning of its range,
+ * idle worker steals upper half of the remaining range of another worker.
+ */
+typedef struct worker
+{
+    pthread_mutex_t lock;
+    uint64_t begin;
+    uint64_t end;
+    unsigned int index;
+    struct thread_pool *pool;
+} worker_t;
+
+typedef struct thread_pool
+{
+    unsigned int worker_count;
+    worker_t *workers;
+    thread_pool_task_t task;
+    void *context;
+    // graph context of calling thread, bound to all workers
+    graph_ctx_t *graph_ctx;
+    // a task failed, workers stop taking tasks and the error is raised on calling thread
+    bool failed;
+} thread_pool_t;
+
+/**
+ * @brief Function returns count of online processors
+ * @return unsigned int processor count, at least 1
+ */
+unsigned int thread_pool_get_processor_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned int)count : 1;
+}
+
+/**
+ * @brief Take next task from worker own range.
+ * @param worker worker structure pointer
+ * @param task_index pointer where task index is stored
+ * @return bool task was taken
+ */
+bool worker_pop_task(worker_t *worker, uint64_t *task_index)
+{
+    bool found = false;
+    pthread_mutex_lock(&worker->lock);
+    if (worker->begin < worker->end && !__atomic_load_n(&worker->pool->failed, __ATOMIC_RELAXED))
+    {
+        *task_index = worker->begin++;
+        found = true;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return found;
+}
+
+/**
+ * @brief Steal upper half of remaining tasks of other workers into worker own range.
+ * @param worker worker structure pointer
+ * @return bool tasks were stolen
+ */
+bool worker_steal_tasks(worker_t *worker)
+{
+    thread_pool_t *pool = worker->pool;
+    for (unsigned int i = 1; i < pool->worker_count && !__atomic_load_n(&pool->failed, __ATOMIC_RELAXED); i++)
+    {
+        worker_t *victim = &pool->workers[(worker->index + i) % pool->worker_count];
+        uint64_t begin = 0;
+        uint64_t end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        uint64_t remaining = victim->end - victim->begin;
+        if (remaining > 0)
+        {
+            end = victim->end;
+            begin = end - (remaining + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end)
+        {
+            pthread_mutex_lock(&worker->lock);
+            worker->begin = begin;
+            worker->end = end;
+            pthread_mutex_unlock(&worker->lock);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Worker thread main loop, runs until there are no tasks to take or steal.
+ * Error of a task is stored to graph context and stops the pool.
+ * @param arg worker structure pointer
+ * @return void* NULL
+ */
+void *worker_run(void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    uint64_t task_index;
+    graph_ctx_bind(worker->pool->graph_ctx);
+    jmp_buf jump;
+    jmp_buf *previous_jump = graph_ctx_set_error_jump(&jump);
+
+    if (setjmp(jump) == 0)
+    {
+        do
+        {
+            while (worker_pop_task(worker, &task_index))
+            {
+                worker->pool->task(worker->pool->context, worker->index, task_index);
+            }
+        } while (worker_steal_tasks(worker));
+    }
+    else
+    {
+        __atomic_store_n(&worker->pool->failed, true, __ATOMIC_RELAXED);
+    }
+
+    graph_ctx_set_error_jump(previous_jump);
+    stats_flush();
+    return NULL;
+}
+
+/**
+ * @brief Run task for every task index on a work stealing pool of threads and wait for all of them.
+ * Calling thread works as worker 0, with single thread all tasks run in order on calling thread.
+ * @throw Error of the first failed task, raised on calling thread after all workers stopped.
+ * @param thread_count count of worker threads
+ * @param task_count count of tasks
+ * @param task task function
+ * @param context shared context passed to task function
+ */
+void thread_pool_run(unsigned int thread_count, uint64_t task_count, thread_pool_task_t task, void *context)
+{
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+    if (task_count < thread_count)
+    {
+        thread_count = task_count ? (unsigned int)task_count : 1;
+    }
+    if (thread_count == 1)
+    {
+        // errors of tasks return from calling thread directly, so nested runs need no pool
+        for (uint64_t i = 0; i < task_count; i++)
+        {
+            task(context, 0, i);
+        }
+        return;
+    }
+
+    thread_pool_t pool = {
+        .worker_count = thread_count,
+        .workers = (worker_t *)alloc(thread_count, sizeof(worker_t)),
+        .task = task,
+        .context = context,
+        .graph_ctx = graph_ctx_current(),
+    };
+    pool.graph_ctx->error_code = noError;
+
+    // split tasks evenly, stealing balances uneven task cost
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        worker_t *worker = &pool.workers[i];
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->begin = task_count * i / thread_count;
+        worker->end = task_count * (i + 1) / thread_count;
+        worker->index = i;
+        worker->pool = &pool;
+    }
+
+    pthread_t *threads = (pthread_t *)alloc(thread_count, sizeof(pthread_t));
+    unsigned int started_count = 1;
+    for (; started_count < thread_count; started_count++)
+    {
+        if (pthread_create(&threads[started_count], NULL, worker_run, &pool.workers[started_count]) != 0)
+        {
+            // remaining ranges get stolen by running workers
+            warning_print("Thread creation failed, running with %u threads\n", started_count);
+            break;
+        }
+    }
+
+    worker_run(&pool.workers[0]);
+
+    for (unsigned int i = 1; i < started_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        pthread_mutex_destroy(&pool.workers[i].lock);
+    }
+    alloc_free(threads);
+    alloc_free(pool.workers);
+    if (pool.failed)
+    {
+        error_exit(pool.graph_ctx->error_code, "%s", pool.graph_ctx->error_message);
+    }
+}
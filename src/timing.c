@@ -0,0 +1,100 @@
+/**
+ * @file timing.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for monotonic nanosecond timing of nested measurements,
+ * time is read from monotonic clock, so it does not jump with system time and counts wall time of all threads
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <time.h>
+#include "../include/timing.h"
+#include "../include/error.h"
+
+/**
+ * @brief Function returns current time of monotonic clock.
+ * @return uint64_t time in nanoseconds from unspecified start
+ */
+uint64_t timing_now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Function starts a new measurement nested in running measurements.
+ * @throw Error when too many measurements run at once.
+ * @param timing timing structure pointer
+ */
+void timing_start(timing_t *timing)
+{
+    if (timing->depth == TIMING_MAX_DEPTH)
+    {
+        error_exit(internalError, "Too many nested time measurements\n");
+    }
+    timing->starts[timing->depth++] = timing_now();
+}
+
+/**
+ * @brief Function stops the most recently started measurement.
+ * @throw Error when no measurement runs.
+ * @param timing timing structure pointer
+ * @return uint64_t measured duration in nanoseconds, also stored as the last duration
+ */
+uint64_t timing_stop(timing_t *timing)
+{
+    uint64_t now = timing_now();
+    if (timing->depth == 0)
+    {
+        error_exit(internalError, "Time measurement was not started\n");
+    }
+    timing->last = now - timing->starts[--timing->depth];
+    return timing->last;
+}
+
+/**
+ * @brief Internal comparison of samples for qsort.
+ * @param sample first sample pointer
+ * @param sample2 second sample pointer
+ * @return int order of samples
+ */
+int timing_compare_samples(const void *sample, const void *sample2)
+{
+    uint64_t first = *(const uint64_t *)sample;
+    uint64_t second = *(const uint64_t *)sample2;
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Internal function returns sample of sorted samples at percentile by nearest rank.
+ * @param samples sorted samples
+ * @param count count of samples
+ * @param percentile percentile (1 - 100)
+ * @return uint64_t sample
+ */
+uint64_t timing_percentile(const uint64_t *samples, unsigned int count, unsigned int percentile)
+{
+    uint64_t rank = ((uint64_t)count * percentile + 99) / 100;
+    return samples[rank ? rank - 1 : 0];
+}
+
+/**
+ * @brief Function computes statistics of repeated measurement, samples are sorted.
+ * @param samples measured durations, at least one
+ * @param count count of samples
+ * @param summary statistics structure pointer
+ */
+void timing_summarize(uint64_t *samples, unsigned int count, timing_summary_t *summary)
+{
+    qsort(samples, count, sizeof(uint64_t), timing_compare_samples);
+    summary->min = samples[0];
+    summary->median = timing_percentile(samples, count, 50);
+    summary->p99 = timing_percentile(samples, count, 99);
+}
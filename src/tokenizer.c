@@ -0,0 +1,126 @@
+/**
+ * @file tokenizer.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of functions and variables for vectorized classification of input characters,
+ * name characters are classified 32 (AVX2) or 16 (SSE2) bytes at a time, implementation is selected
+ * by CPU features when parsing starts, other platforms use scalar loop, delimiters are single bytes
+ * between names and stay in the parser state machine
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../include/tokenizer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TOKENIZER_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Check if character can be a part of node name
+ * @param c character
+ * @return bool character is alphanumeric
+ */
+bool tokenizer_is_name_char(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+/**
+ * @brief Scalar scan of name characters.
+ * @param data input data
+ * @param length input data length
+ * @return size_t count of name characters at the beginning of data
+ */
+size_t scan_name_scalar(const char *data, size_t length)
+{
+    size_t i = 0;
+    while (i < length && tokenizer_is_name_char((unsigned char)data[i]))
+    {
+        i++;
+    }
+    return i;
+}
+
+#ifdef TOKENIZER_X86
+/**
+ * @brief SSE2 scan of name characters, every block of 16 bytes is compared with the bounds
+ * of the 3 character ranges (bytes above 127 are negative, so they are never in range),
+ * the first zero bit of the resulting mask is the end of the name.
+ * @param data input data
+ * @param length input data length
+ * @return size_t count of name characters at the beginning of data
+ */
+__attribute__((target("sse2"))) size_t scan_name_sse2(const char *data, size_t length)
+{
+    const __m128i digit_low = _mm_set1_epi8('0' - 1), digit_high = _mm_set1_epi8('9' + 1);
+    const __m128i upper_low = _mm_set1_epi8('A' - 1), upper_high = _mm_set1_epi8('Z' + 1);
+    const __m128i lower_low = _mm_set1_epi8('a' - 1), lower_high = _mm_set1_epi8('z' + 1);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(block, digit_low), _mm_cmplt_epi8(block, digit_high));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, upper_low), _mm_cmplt_epi8(block, upper_high));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(block, lower_low), _mm_cmplt_epi8(block, lower_high));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(digit, _mm_or_si128(upper, lower)));
+        if (mask != 0xFFFF)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return i + scan_name_scalar(data + i, length - i);
+}
+
+/**
+ * @brief AVX2 scan of name characters, same as SSE2 scan with 32 bytes blocks.
+ * @param data input data
+ * @param length input data length
+ * @return size_t count of name characters at the beginning of data
+ */
+__attribute__((target("avx2"))) size_t scan_name_avx2(const char *data, size_t length)
+{
+    const __m256i digit_low = _mm256_set1_epi8('0' - 1), digit_high = _mm256_set1_epi8('9' + 1);
+    const __m256i upper_low = _mm256_set1_epi8('A' - 1), upper_high = _mm256_set1_epi8('Z' + 1);
+    const __m256i lower_low = _mm256_set1_epi8('a' - 1), lower_high = _mm256_set1_epi8('z' + 1);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(block, digit_low), _mm256_cmpgt_epi8(digit_high, block));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, upper_low), _mm256_cmpgt_epi8(upper_high, block));
+        __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(block, lower_low), _mm256_cmpgt_epi8(lower_high, block));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(digit, _mm256_or_si256(upper, lower)));
+        if (mask != 0xFFFFFFFFu)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return i + scan_name_sse2(data + i, length - i);
+}
+#endif
+
+/**
+ * @brief Function selects scan of name characters supported by CPU, parser selects it once per input.
+ * @return tokenizer_scan_t scan function
+ */
+tokenizer_scan_t tokenizer_select_scan()
+{
+#ifdef TOKENIZER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return scan_name_avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return scan_name_sse2;
+    }
+#endif
+    return scan_name_scalar;
+}
@@ -0,0 +1,130 @@
+#!/bin/sh
+# Benchmark suite of graph properties
+# Marek Gergel (xgerge01)
+#
+# Graphs of growing size are generated for every series, each graph is analyzed REPEAT times
+# and median runtime of every property is recorded. Growth exponent b of runtime ~ (|V|+|E|)^b
+# is fitted by least squares on log-log scale and compared with exponent of documented complexity,
+# so a property which got slower than its complexity is reported as regression. Properties whose runtime
+# stays below 10 us are dominated by clock overhead and are never reported.
+#
+# Usage: tools/bench.sh [OUTPUT_DIR]
+# OUTPUT_DIR/bench.csv has all measurements, OUTPUT_DIR/bench.json has fitted exponents.
+# Environment: PROG, GEN (program paths), REPEAT (runs per graph), SEED, TOLERANCE (allowed exponent excess)
+
+set -e
+
+PROG=${PROG:-./graph_properties}
+GEN=${GEN:-./gen_graph}
+OUT=${1:-bench}
+REPEAT=${REPEAT:-5}
+SEED=${SEED:-1}
+TOLERANCE=${TOLERANCE:-0.5}
+
+# cycles are counted up to length 4, counting all cycles is exponential
+CYCLE_LENGTH_LIMIT=4
+
+mkdir -p "$OUT"
+graph="$OUT/graph.gbin"
+csv="$OUT/bench.csv"
+json="$OUT/bench.json"
+
+echo "series,nodes,edges,property,min_s,median_s,p99_s" > "$csv"
+
+# run_graph SERIES GENERATOR_ARGUMENTS...
+# generates one graph and appends runtimes of all its properties to csv
+run_graph() {
+    series=$1
+    shift
+    "$GEN" --seed "$SEED" --binary "$graph" "$@" 2>/dev/null
+    "$PROG" --repeat "$REPEAT" --cycles-upto "$CYCLE_LENGTH_LIMIT" < "$graph" | awk -v series="$series" '
+        /runtime:/ {
+            label = $0
+            sub(/runtime:.*/, "", label)
+            times = $0
+            sub(/.*runtime:/, "", times)
+            gsub(/min|median|p99|s/, " ", times)
+            count = split(times, time, " ")
+            if (count == 1) { time[2] = time[1]; time[3] = time[1] }
+
+            if (label ~ /^Node count/) { property = "node_count"; split(label, value, " "); nodes = value[3] }
+            else if (label ~ /^Edge count/) { property = "edge_count"; split(label, value, " "); edges = value[3] }
+            else if (label ~ /^Component count/) property = "component_count"
+            else if (label ~ /^Cycle count/) property = "cycle_count"
+            else if (label ~ /^Maximum degree/) property = "max_degree"
+            else if (label ~ /connected/) property = "connected"
+            else if (label ~ /complete/) property = "complete"
+            else if (label ~ /tree/) property = "tree"
+            else if (label ~ /forest/) property = "forest"
+            else next
+            properties[++property_count] = property
+            minimum[property] = time[1]; median[property] = time[2]; p99[property] = time[3]
+        }
+        END {
+            for (i = 1; i <= property_count; i++) {
+                property = properties[i]
+                printf "%s,%s,%s,%s,%s,%s,%s\n", series, nodes, edges, property, minimum[property], median[property], p99[property]
+            }
+        }' >> "$csv"
+    echo "$series $*" >&2
+}
+
+# sparse Erdős–Rényi graphs with average degree 8
+for nodes in 16384 32768 65536 131072 262144; do
+    run_graph sparse er "$nodes" "$(awk -v n="$nodes" 'BEGIN { printf "%.12f", 8 / (n - 1) }')"
+done
+# dense Erdős–Rényi graphs with half of all edges
+for nodes in 256 512 1024 2048; do
+    run_graph dense er "$nodes" 0.5
+done
+# random trees
+for nodes in 65536 131072 262144 524288 1048576; do
+    run_graph tree tree "$nodes"
+done
+# square grids
+for side in 64 128 256 512; do
+    run_graph grid grid "$side" "$side"
+done
+# Barabási–Albert graphs with 4 edges of every new node
+for nodes in 16384 32768 65536 131072 262144; do
+    run_graph power_law ba "$nodes" 4
+done
+rm -f "$graph"
+
+# exponents of documented time complexity in |V|+|E|, derived properties are O(1) with memoized component count
+# but their documented bound is kept, short cycles up to length 4 are O(|E| * sqrt(|E|))
+awk -F, -v repeat="$REPEAT" -v seed="$SEED" -v tolerance="$TOLERANCE" '
+    BEGIN {
+        expected["node_count"] = 0; expected["edge_count"] = 0; expected["component_count"] = 1
+        expected["cycle_count"] = 1.5; expected["max_degree"] = 1; expected["connected"] = 1
+        expected["complete"] = 0; expected["tree"] = 1; expected["forest"] = 1
+    }
+    NR > 1 {
+        key = $1 "," $4
+        if (!(key in count)) keys[++key_count] = key
+        x = log($2 + $3)
+        # runtime below clock resolution is rounded up to 1 ns
+        y = log($6 > 1e-9 ? $6 : 1e-9)
+        count[key]++; sum_x[key] += x; sum_y[key] += y; sum_xx[key] += x * x; sum_xy[key] += x * y
+        if ($6 > slowest[key]) slowest[key] = $6
+    }
+    END {
+        printf "{\n  \"repeat\": %d,\n  \"seed\": %d,\n  \"tolerance\": %s,\n  \"fits\": [\n", repeat, seed, tolerance
+        regressions = 0
+        for (i = 1; i <= key_count; i++) {
+            key = keys[i]
+            split(key, part, ",")
+            n = count[key]
+            denominator = n * sum_xx[key] - sum_x[key] * sum_x[key]
+            exponent = denominator != 0 ? (n * sum_xy[key] - sum_x[key] * sum_y[key]) / denominator : 0
+            regression = exponent > expected[part[2]] + tolerance && slowest[key] >= 1e-5
+            regressions += regression
+            printf "    {\"series\": \"%s\", \"property\": \"%s\", \"points\": %d, \"exponent\": %.3f, \"expected\": %s, \"regression\": %s}%s\n", \
+                part[1], part[2], n, exponent, expected[part[2]], regression ? "true" : "false", i < key_count ? "," : ""
+            printf "%-10s %-16s exponent %6.3f  expected <= %s%s\n", part[1], part[2], exponent, expected[part[2]], \
+                regression ? "  REGRESSION" : "" > "/dev/stderr"
+        }
+        printf "  ],\n  \"regressions\": %d\n}\n", regressions
+    }' "$csv" > "$json"
+
+echo "Report written to $csv and $json" >&2
@@ -0,0 +1,732 @@
+/**
+ * @file gen_graph.c
+ * @author Marek Gergel (xgerge01)
+ * @brief definition of main function of synthetic graph generator, graphs of random and regular families
+ * are generated from seed as stream of edges and written in text graph format or binary graph format,
+ * so graphs much larger than test data can be analyzed
+ * @version 0.1
+ * @date 2022-10-26
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <math.h>
+#include <inttypes.h>
+#include "../include/graph.h"
+
+// size of stdout buffer of text graph
+#define TEXT_BUFFER_SIZE (1 << 20)
+// size of buffer for decimal node name
+#define NUMBER_NAME_SIZE 11
+
+/**
+ * @brief Supported graph families.
+ */
+typedef enum family
+{
+    erdosRenyiFamily,
+    treeFamily,
+    forestFamily,
+    completeFamily,
+    gridFamily,
+    barabasiAlbertFamily,
+    cliquesFamily
+} family_t;
+
+/**
+ * @brief Generated graph, node count and family parameters.
+ */
+typedef struct generator
+{
+    family_t family;
+    uint64_t seed;
+    uint32_t node_count;
+    // edge probability of Erdős–Rényi graph
+    double probability;
+    // tree count of forest, column count of grid, edge count of new Barabási–Albert node or clique size
+    uint32_t parameter;
+} generator_t;
+
+/**
+ * @brief State of xoshiro256** pseudo random number generator.
+ */
+typedef struct rng
+{
+    uint64_t state[4];
+} rng_t;
+
+/**
+ * @brief Edge callback, called once for every generated edge
+ * @param context output context
+ * @param node first node index
+ * @param node2 second node index
+ */
+typedef void (*edge_callback_t)(void *context, uint32_t node, uint32_t node2);
+
+/**
+ * @brief Function initializes random number generator, the same seed generates the same numbers.
+ * State is expanded from seed by splitmix64.
+ * @param rng generator structure pointer
+ * @param seed seed
+ */
+void rng_init(rng_t *rng, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        seed += 0x9e3779b97f4a7c15u;
+        uint64_t value = seed;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9u;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebu;
+        rng->state[i] = value ^ (value >> 31);
+    }
+}
+
+/**
+ * @brief Function returns next random 64-bit number.
+ * @param rng generator structure pointer
+ * @return uint64_t random number
+ */
+uint64_t rng_next(rng_t *rng)
+{
+    uint64_t *state = rng->state;
+    uint64_t rotated = state[1] * 5;
+    uint64_t result = ((rotated << 7) | (rotated >> 57)) * 9;
+    uint64_t shifted = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = (state[3] << 45) | (state[3] >> 19);
+    return result;
+}
+
+/**
+ * @brief Function returns uniformly distributed random number below bound, biased numbers are rejected.
+ * @param rng generator structure pointer
+ * @param bound bound (> 0)
+ * @return uint64_t random number from 0 to bound - 1
+ */
+uint64_t rng_below(rng_t *rng, uint64_t bound)
+{
+    uint64_t threshold = -bound % bound;
+    uint64_t value;
+    do
+    {
+        value = rng_next(rng);
+    } while (value < threshold);
+    return value % bound;
+}
+
+/**
+ * @brief Function returns uniformly distributed random number from [0, 1).
+ * @param rng generator structure pointer
+ * @return double random number
+ */
+double rng_uniform(rng_t *rng)
+{
+    return (double)(rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Generate Erdős–Rényi graph G(n, p), every pair of nodes is joined with probability p.
+ * Gaps between joined pairs are drawn from geometric distribution (Batagelj and Brandes),
+ * so only generated edges are visited.
+ *
+ * Time complexity: O(|V|+|E|)
+ * @param generator generator settings
+ * @param rng random number generator
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_erdos_renyi(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    uint32_t node_count = generator->node_count;
+    if (generator->probability <= 0)
+    {
+        return;
+    }
+    if (generator->probability >= 1)
+    {
+        for (uint32_t node = 1; node < node_count; node++)
+        {
+            for (uint32_t node2 = 0; node2 < node; node2++)
+            {
+                callback(context, node, node2);
+            }
+        }
+        return;
+    }
+
+    // pairs (node, node2) with node2 < node are visited in order, candidate is next unvisited node2
+    double log_miss = log(1 - generator->probability);
+    double pair_count = (double)node_count * (node_count - 1) / 2;
+    uint64_t node = 1;
+    uint64_t candidate = 0;
+    while (node < node_count)
+    {
+        double skip = floor(log(1 - rng_uniform(rng)) / log_miss);
+        // skip longer than all pairs ends the graph
+        if (skip >= pair_count)
+        {
+            return;
+        }
+        candidate += (uint64_t)skip;
+        while (candidate >= node && node < node_count)
+        {
+            candidate -= node;
+            node++;
+        }
+        if (node < node_count)
+        {
+            callback(context, (uint32_t)node, (uint32_t)candidate);
+            candidate++;
+        }
+    }
+}
+
+/**
+ * @brief Generate random forest, the first tree count nodes are roots and every other node is joined
+ * to uniformly chosen node with smaller index. Tree is forest with one tree.
+ *
+ * Time complexity: O(|V|)
+ * @param generator generator settings
+ * @param rng random number generator
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_forest(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    for (uint32_t node = generator->parameter; node < generator->node_count; node++)
+    {
+        callback(context, (uint32_t)rng_below(rng, node), node);
+    }
+}
+
+/**
+ * @brief Generate complete graph.
+ *
+ * Time complexity: O(|V|^2)
+ * @param generator generator settings
+ * @param rng random number generator (unused)
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_complete(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    (void)rng;
+    for (uint32_t node = 0; node < generator->node_count; node++)
+    {
+        for (uint32_t node2 = node + 1; node2 < generator->node_count; node2++)
+        {
+            callback(context, node, node2);
+        }
+    }
+}
+
+/**
+ * @brief Generate grid graph, node in row r and column c has index r * columns + c
+ * and is joined to its right and lower neighbor.
+ *
+ * Time complexity: O(|V|)
+ * @param generator generator settings
+ * @param rng random number generator (unused)
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_grid(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    (void)rng;
+    uint32_t columns = generator->parameter;
+    for (uint32_t node = 0; node < generator->node_count; node++)
+    {
+        if ((node + 1) % columns != 0)
+        {
+            callback(context, node, node + 1);
+        }
+        if ((uint64_t)node + columns < generator->node_count)
+        {
+            callback(context, node, node + columns);
+        }
+    }
+}
+
+/**
+ * @brief Generate Barabási–Albert graph, nodes of initial complete graph of m + 1 nodes are followed by nodes
+ * joined to m distinct nodes chosen with probability proportional to their degree.
+ * Nodes are chosen from list of endpoints of all generated edges, so the list takes 8 bytes per edge.
+ *
+ * Time complexity: O(|V| * m)
+ * @param generator generator settings
+ * @param rng random number generator
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_barabasi_albert(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    uint32_t node_count = generator->node_count;
+    uint32_t edges_per_node = generator->parameter;
+    uint64_t edge_count = (uint64_t)edges_per_node * (edges_per_node + 1) / 2 + (uint64_t)(node_count - edges_per_node - 1) * edges_per_node;
+    uint32_t *endpoints = (uint32_t *)alloc((size_t)edge_count * 2, sizeof(uint32_t));
+    uint32_t *targets = (uint32_t *)alloc(edges_per_node, sizeof(uint32_t));
+    uint64_t endpoint_count = 0;
+
+    for (uint32_t node = 0; node <= edges_per_node; node++)
+    {
+        for (uint32_t node2 = 0; node2 < node; node2++)
+        {
+            callback(context, node2, node);
+            endpoints[endpoint_count++] = node2;
+            endpoints[endpoint_count++] = node;
+        }
+    }
+    for (uint32_t node = edges_per_node + 1; node < node_count; node++)
+    {
+        for (uint32_t i = 0; i < edges_per_node; i++)
+        {
+            bool duplicate;
+            do
+            {
+                targets[i] = endpoints[rng_below(rng, endpoint_count)];
+                duplicate = false;
+                for (uint32_t j = 0; j < i && !duplicate; j++)
+                {
+                    duplicate = targets[j] == targets[i];
+                }
+            } while (duplicate);
+        }
+        for (uint32_t i = 0; i < edges_per_node; i++)
+        {
+            callback(context, targets[i], node);
+            endpoints[endpoint_count++] = targets[i];
+            endpoints[endpoint_count++] = node;
+        }
+    }
+
+    alloc_free(endpoints);
+    alloc_free(targets);
+}
+
+/**
+ * @brief Generate disjoint complete graphs of clique size nodes.
+ *
+ * Time complexity: O(|V| * clique size)
+ * @param generator generator settings
+ * @param rng random number generator (unused)
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate_cliques(const generator_t *generator, rng_t *rng, edge_callback_t callback, void *context)
+{
+    (void)rng;
+    uint32_t clique_size = generator->parameter;
+    for (uint32_t first = 0; first < generator->node_count; first += clique_size)
+    {
+        for (uint32_t node = first; node < first + clique_size; node++)
+        {
+            for (uint32_t node2 = node + 1; node2 < first + clique_size; node2++)
+            {
+                callback(context, node, node2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Generate graph as stream of edges, every edge is generated once and graph has no loops,
+ * the same generator settings always generate the same edges in the same order.
+ * @param generator generator settings
+ * @param callback edge callback
+ * @param context callback context
+ */
+void generate(const generator_t *generator, edge_callback_t callback, void *context)
+{
+    rng_t rng;
+    rng_init(&rng, generator->seed);
+    switch (generator->family)
+    {
+    case erdosRenyiFamily:
+        generate_erdos_renyi(generator, &rng, callback, context);
+        break;
+    case treeFamily:
+    case forestFamily:
+        generate_forest(generator, &rng, callback, context);
+        break;
+    case completeFamily:
+        generate_complete(generator, &rng, callback, context);
+        break;
+    case gridFamily:
+        generate_grid(generator, &rng, callback, context);
+        break;
+    case barabasiAlbertFamily:
+        generate_barabasi_albert(generator, &rng, callback, context);
+        break;
+    case cliquesFamily:
+        generate_cliques(generator, &rng, callback, context);
+        break;
+    }
+}
+
+/**
+ * @brief Write decimal number without formatting.
+ * @param number number
+ * @param stream output stream
+ */
+void write_number(uint32_t number, FILE *stream)
+{
+    char buffer[NUMBER_NAME_SIZE];
+    int position = NUMBER_NAME_SIZE;
+    do
+    {
+        buffer[--position] = (char)('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    fwrite(&buffer[position], 1, (size_t)(NUMBER_NAME_SIZE - position), stream);
+}
+
+/**
+ * @brief State of text graph output.
+ */
+typedef struct text_output
+{
+    FILE *stream;
+    bool first;
+} text_output_t;
+
+/**
+ * @brief Edge callback writing edge to text graph edge list.
+ * @param context text output state
+ * @param node first node index
+ * @param node2 second node index
+ */
+void text_write_edge(void *context, uint32_t node, uint32_t node2)
+{
+    text_output_t *output = (text_output_t *)context;
+    if (!output->first)
+    {
+        fputc(',', output->stream);
+    }
+    output->first = false;
+    fputc('(', output->stream);
+    write_number(node, output->stream);
+    fputc(',', output->stream);
+    write_number(node2, output->stream);
+    fputc(')', output->stream);
+}
+
+/**
+ * @brief Write generated graph to stream in text graph format, nodes are named by their index.
+ * Edges are written as they are generated.
+ * @throw Error when graph can not be written.
+ * @param generator generator settings
+ * @param stream output stream
+ */
+void write_text(const generator_t *generator, FILE *stream)
+{
+    setvbuf(stream, NULL, _IOFBF, TEXT_BUFFER_SIZE);
+    fputc('{', stream);
+    for (uint32_t node = 0; node < generator->node_count; node++)
+    {
+        if (node != 0)
+        {
+            fputc(',', stream);
+        }
+        write_number(node, stream);
+    }
+    fputs("}\n{", stream);
+    text_output_t output = {.stream = stream, .first = true};
+    generate(generator, text_write_edge, &output);
+    fputs("}\n", stream);
+    if (fflush(stream) != 0 || ferror(stream))
+    {
+        error_exit(fileAccessError, "Graph can not be written\n");
+    }
+}
+
+/**
+ * @brief State of binary graph output, edges are counted in the first pass and placed in the second pass.
+ */
+typedef struct binary_output
+{
+    // node degrees in the first pass, next free position of node neighbors in the second pass
+    uint64_t *positions;
+    uint32_t *edge_nodes;
+    uint64_t edge_count;
+} binary_output_t;
+
+/**
+ * @brief Edge callback counting node degrees.
+ * @param context binary output state
+ * @param node first node index
+ * @param node2 second node index
+ */
+void binary_count_edge(void *context, uint32_t node, uint32_t node2)
+{
+    binary_output_t *output = (binary_output_t *)context;
+    output->positions[node]++;
+    output->positions[node2]++;
+    output->edge_count++;
+}
+
+/**
+ * @brief Edge callback placing edge to neighbors of both nodes.
+ * @param context binary output state
+ * @param node first node index
+ * @param node2 second node index
+ */
+void binary_place_edge(void *context, uint32_t node, uint32_t node2)
+{
+    binary_output_t *output = (binary_output_t *)context;
+    output->edge_nodes[output->positions[node]++] = node2;
+    output->edge_nodes[output->positions[node2]++] = node;
+}
+
+/**
+ * @brief Internal comparison of node indexes for qsort.
+ * @param node first node index pointer
+ * @param node2 second node index pointer
+ * @return int order of indexes
+ */
+int compare_nodes(const void *node, const void *node2)
+{
+    uint32_t first = *(const uint32_t *)node;
+    uint32_t second = *(const uint32_t *)node2;
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Write generated graph to file in binary graph format, nodes are named by their index.
+ * Graph is generated twice, degrees are counted first, then file is mapped to memory
+ * and edges are written directly to their CSR positions, so only O(|V|) memory is allocated.
+ * @throw Error when file can not be written.
+ * @param generator generator settings
+ * @param path output file path
+ */
+void write_binary(const generator_t *generator, const char *path)
+{
+    uint32_t node_count = generator->node_count;
+    binary_output_t output = {.positions = (uint64_t *)alloc((size_t)node_count, sizeof(uint64_t))};
+    generate(generator, binary_count_edge, &output);
+
+    graph_binary_header_t header = {
+        .version = GRAPH_BINARY_VERSION,
+        .node_count = node_count,
+        .edge_count = output.edge_count,
+        .arc_count = output.edge_count * 2,
+        .edge_offsets_position = sizeof(graph_binary_header_t),
+    };
+    memcpy(header.magic, GRAPH_BINARY_MAGIC, GRAPH_BINARY_MAGIC_LENGTH);
+    for (uint32_t node = 0; node < node_count; node++)
+    {
+        char buffer[NUMBER_NAME_SIZE + 1];
+        header.names_length += (uint64_t)snprintf(buffer, sizeof(buffer), "%" PRIu32, node) + 1;
+    }
+    header.edge_nodes_position = header.edge_offsets_position + ((uint64_t)node_count + 1) * sizeof(uint64_t);
+    uint64_t edge_nodes_length = header.arc_count * sizeof(uint32_t);
+    header.name_offsets_position = header.edge_nodes_position + edge_nodes_length + (-edge_nodes_length % sizeof(uint64_t));
+    header.names_position = header.name_offsets_position + ((uint64_t)node_count + 1) * sizeof(uint64_t);
+    uint64_t length = header.names_position + header.names_length;
+
+    FILE *file = fopen(path, "w+b");
+    if (!file)
+    {
+        error_exit(fileAccessError, "File '%s' can not be opened\n", path);
+    }
+    if (length > SIZE_MAX || ftruncate(fileno(file), (off_t)length) != 0)
+    {
+        error_exit(fileAccessError, "File '%s' can not be written\n", path);
+    }
+    char *data = (char *)mmap(NULL, (size_t)length, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+    if (data == MAP_FAILED)
+    {
+        error_exit(fileAccessError, "File '%s' can not be mapped\n", path);
+    }
+
+    memcpy(data, &header, sizeof(header));
+    uint64_t *edge_offsets = (uint64_t *)(data + header.edge_offsets_position);
+    for (uint32_t node = 0; node < node_count; node++)
+    {
+        edge_offsets[node + 1] = edge_offsets[node] + output.positions[node];
+        output.positions[node] = edge_offsets[node];
+    }
+    output.edge_nodes = (uint32_t *)(data + header.edge_nodes_position);
+    generate(generator, binary_place_edge, &output);
+    for (uint32_t node = 0; node < node_count; node++)
+    {
+        uint64_t degree = edge_offsets[node + 1] - edge_offsets[node];
+        qsort(&output.edge_nodes[edge_offsets[node]], (size_t)degree, sizeof(uint32_t), compare_nodes);
+    }
+
+    uint64_t *name_offsets = (uint64_t *)(data + header.name_offsets_position);
+    char *names = data + header.names_position;
+    for (uint32_t node = 0; node < node_count; node++)
+    {
+        int name_length = snprintf(&names[name_offsets[node]], NUMBER_NAME_SIZE + 1, "%" PRIu32, node);
+        name_offsets[node + 1] = name_offsets[node] + (uint64_t)name_length + 1;
+    }
+
+    if (munmap(data, (size_t)length) != 0 || fclose(file) != 0)
+    {
+        error_exit(fileAccessError, "File '%s' can not be written\n", path);
+    }
+    alloc_free(output.positions);
+    fprintf(stderr, "Generated %" PRIu32 " nodes and %" PRIu64 " edges to '%s'\n", node_count, output.edge_count, path);
+}
+
+/**
+ * @brief Print program help message
+ */
+void print_help()
+{
+    printf("Program generates unoriented graph and writes it to stdout in text graph format\n");
+    printf("Usage: ./gen_graph [--seed S] [--binary FILE] FAMILY PARAMETERS\n");
+    printf("Families:\n");
+    printf("  er N P\t\tErdős–Rényi graph, N nodes joined with probability P\n");
+    printf("  tree N\t\trandom tree of N nodes\n");
+    printf("  forest N K\t\trandom forest of N nodes and K trees\n");
+    printf("  complete N\t\tcomplete graph of N nodes\n");
+    printf("  grid R C\t\tgrid of R rows and C columns\n");
+    printf("  ba N M\t\tBarabási–Albert graph of N nodes, every new node is joined to M nodes\n");
+    printf("  cliques K S\t\tK disjoint complete graphs of S nodes\n");
+    printf("Options:\n");
+    printf("  --seed S\tseed of random families (default 1)\n");
+    printf("  --binary FILE\twrite graph to FILE in binary graph format instead of stdout\n");
+}
+
+/**
+ * @brief Parse unsigned number program argument
+ * @param arg argument string
+ * @param max maximal value
+ * @param value pointer where parsed value is stored
+ * @return bool argument is a valid unsigned number up to max
+ */
+bool parse_number_arg(const char *arg, uint64_t max, uint64_t *value)
+{
+    char *end = NULL;
+    unsigned long long parsed = strtoull(arg, &end, 10);
+    if (*arg < '0' || *arg > '9' || *end != '\0' || parsed > max)
+    {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+/**
+ * @brief Parse family and its parameters
+ * @param argc count of family arguments
+ * @param argv family arguments
+ * @param generator generator settings
+ * @return bool family and parameters are valid
+ */
+bool parse_family(int argc, char *argv[], generator_t *generator)
+{
+    uint64_t value = 0, value2 = 0;
+    if (argc == 2 && parse_number_arg(argv[1], MAX_NODE_COUNT, &value) && value != 0)
+    {
+        generator->node_count = (uint32_t)value;
+        if (strcmp(argv[0], "tree") == 0)
+        {
+            generator->family = treeFamily;
+            generator->parameter = 1;
+            return true;
+        }
+        if (strcmp(argv[0], "complete") == 0)
+        {
+            generator->family = completeFamily;
+            return true;
+        }
+        return false;
+    }
+    if (argc != 3 || !parse_number_arg(argv[1], MAX_NODE_COUNT, &value) || value == 0)
+    {
+        return false;
+    }
+    generator->node_count = (uint32_t)value;
+    if (strcmp(argv[0], "er") == 0)
+    {
+        char *end = NULL;
+        generator->family = erdosRenyiFamily;
+        generator->probability = strtod(argv[2], &end);
+        return *argv[2] != '\0' && *end == '\0' && generator->probability >= 0 && generator->probability <= 1;
+    }
+    if (!parse_number_arg(argv[2], MAX_NODE_COUNT, &value2) || value2 == 0)
+    {
+        return false;
+    }
+    generator->parameter = (uint32_t)value2;
+    if (strcmp(argv[0], "forest") == 0)
+    {
+        generator->family = forestFamily;
+        return value2 <= value;
+    }
+    if (strcmp(argv[0], "ba") == 0)
+    {
+        generator->family = barabasiAlbertFamily;
+        return value2 < value;
+    }
+    // grid and cliques get node count from rows and columns or clique count and size
+    if (value * value2 > MAX_NODE_COUNT)
+    {
+        return false;
+    }
+    generator->node_count = (uint32_t)(value * value2);
+    if (strcmp(argv[0], "grid") == 0)
+    {
+        generator->family = gridFamily;
+        return true;
+    }
+    if (strcmp(argv[0], "cliques") == 0)
+    {
+        generator->family = cliquesFamily;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Program generates graph and writes it to stdout or binary graph file
+ * @return int exit code
+ */
+int main(int argc, char *argv[])
+{
+    generator_t generator = {.seed = 1};
+    const char *binary_path = NULL;
+    int i = 1;
+    for (; i + 1 < argc && strncmp(argv[i], "--", 2) == 0; i += 2)
+    {
+        uint64_t value = 0;
+        if (strcmp(argv[i], "--seed") == 0 && parse_number_arg(argv[i + 1], UINT64_MAX, &value))
+        {
+            generator.seed = value;
+        }
+        else if (strcmp(argv[i], "--binary") == 0)
+        {
+            binary_path = argv[i + 1];
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (i >= argc || !parse_family(argc - i, &argv[i], &generator))
+    {
+        print_help();
+        return 0;
+    }
+
+    if (binary_path)
+    {
+        write_binary(&generator, binary_path);
+    }
+    else
+    {
+        write_text(&generator, stdout);
+    }
+    return 0;
+}